@@ -12,11 +12,29 @@
 #include <shared_mutex>
 #include <thread>
 #include <unordered_map>
+#include <vector>
+#include <functional>
+#include <cstdint>
 #include <cassert>
 #include <stdexcept>
 #include <ctime>
 #include <ratio>
 #include <chrono>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <condition_variable>
+#include <memory>
+#include <array>
+#include <map>
+#include <string>
+#include <sstream>
+#include <typeinfo>
+#include <tuple>
+#include <algorithm>
+#include <utility>
+#include <deque>
+#include <list>
 
 #if defined(MSE_SAFER_SUBSTITUTES_DISABLED) || defined(MSE_SAFERPTR_DISABLED)
 #define MSE_ASYNCSHAREDPOINTER_DISABLED
@@ -29,6 +47,12 @@
 #define MSE_THROW(x) throw(x)
 #endif // MSE_CUSTOM_THROW_DEFINITION
 
+#ifndef MSE_ASYNCSHARED_CACHE_LINE_SIZE
+/* The granularity used when padding data to avoid "false sharing" between threads. 64 bytes is correct for most
+current x86 and ARM processors. */
+#define MSE_ASYNCSHARED_CACHE_LINE_SIZE 64
+#endif // !MSE_ASYNCSHARED_CACHE_LINE_SIZE
+
 namespace mse {
 
 #ifdef MSE_ASYNCSHAREDPOINTER_DISABLED
@@ -61,6 +85,166 @@ namespace mse {
 		_Ty& m_mutex_ref;
 	};
 
+	/* TAsyncSharedCacheLineAlignedAllocator is an allocator adaptor that aligns its allocations to (at least) cache line
+	boundaries. The memory itself is obtained from the given "base" allocator. */
+	template<typename _Ty, class _TBaseAllocator = std::allocator<_Ty>>
+	class TAsyncSharedCacheLineAlignedAllocator {
+	public:
+		typedef _Ty value_type;
+		typedef _TBaseAllocator base_allocator_type;
+		template<typename _Ty2>
+		struct rebind {
+			typedef TAsyncSharedCacheLineAlignedAllocator<_Ty2, typename std::allocator_traits<_TBaseAllocator>::template rebind_alloc<_Ty2>> other;
+		};
+
+		TAsyncSharedCacheLineAlignedAllocator(const _TBaseAllocator& base_allocator = _TBaseAllocator()) : m_base_allocator(base_allocator) {}
+		template<typename _Ty2, class _TBaseAllocator2>
+		TAsyncSharedCacheLineAlignedAllocator(const TAsyncSharedCacheLineAlignedAllocator<_Ty2, _TBaseAllocator2>& src)
+			: m_base_allocator(src.base_allocator()) {}
+
+		_Ty* allocate(size_t n) {
+			byte_allocator_type byte_allocator(m_base_allocator);
+			char* raw_ptr = std::allocator_traits<byte_allocator_type>::allocate(byte_allocator, number_of_bytes_to_allocate(n));
+			/* The pointer to the allocated block is stored immediately preceding the (aligned) pointer we return. */
+			const auto aligned_address = (reinterpret_cast<std::uintptr_t>(raw_ptr) + sizeof(char*) + (alignment - 1)) & ~std::uintptr_t(alignment - 1);
+			char* aligned_ptr = reinterpret_cast<char*>(aligned_address);
+			reinterpret_cast<char**>(aligned_ptr)[-1] = raw_ptr;
+			return reinterpret_cast<_Ty*>(aligned_ptr);
+		}
+		void deallocate(_Ty* ptr, size_t n) {
+			byte_allocator_type byte_allocator(m_base_allocator);
+			char* raw_ptr = reinterpret_cast<char**>(ptr)[-1];
+			std::allocator_traits<byte_allocator_type>::deallocate(byte_allocator, raw_ptr, number_of_bytes_to_allocate(n));
+		}
+
+		const _TBaseAllocator& base_allocator() const { return m_base_allocator; }
+		template<typename _Ty2, class _TBaseAllocator2>
+		bool operator==(const TAsyncSharedCacheLineAlignedAllocator<_Ty2, _TBaseAllocator2>& rhs) const {
+			return (byte_allocator_type(m_base_allocator) == byte_allocator_type(rhs.base_allocator()));
+		}
+		template<typename _Ty2, class _TBaseAllocator2>
+		bool operator!=(const TAsyncSharedCacheLineAlignedAllocator<_Ty2, _TBaseAllocator2>& rhs) const {
+			return !((*this) == rhs);
+		}
+
+	private:
+		typedef typename std::allocator_traits<_TBaseAllocator>::template rebind_alloc<char> byte_allocator_type;
+		static const size_t alignment = (alignof(_Ty) > size_t(MSE_ASYNCSHARED_CACHE_LINE_SIZE)) ? alignof(_Ty) : size_t(MSE_ASYNCSHARED_CACHE_LINE_SIZE);
+		static size_t number_of_bytes_to_allocate(size_t n) {
+			return n * sizeof(_Ty) + sizeof(char*) + (alignment - 1);
+		}
+
+		_TBaseAllocator m_base_allocator;
+	};
+
+	struct asyncshared_big_reader_lock_mode_t {};
+	/* Passing asyncshared_big_reader_lock_mode as the first argument to an access requester's make() (or allocate())
+	function opts the shared object into the "big reader" lock mode. */
+	static const asyncshared_big_reader_lock_mode_t asyncshared_big_reader_lock_mode = asyncshared_big_reader_lock_mode_t();
+
+	namespace impl {
+		namespace asyncshared {
+			/* big_reader_indicators supports the "big reader" lock mode. Rather than a single (contended) count of read
+			lock holders, each thread is assigned one of a number of "slots" (each on its own cache line) in which its read
+			locks are counted. So readers generally only modify their own cache line, while a writer has to check (and
+			wait for) every slot. This makes read locks scale with the number of cores at the expense of write locks. */
+			class big_reader_indicators {
+			public:
+				big_reader_indicators() : m_slots(default_number_of_slots()), m_slot_index_mask(m_slots.size() - 1) {}
+
+				/* Returns true if no writer is active (in which case the read lock is held). Otherwise the read is
+				"backed out" and false is returned. */
+				bool try_lock_shared() {
+					auto& count_ref = this_thread_slot().m_count;
+					count_ref.fetch_add(1);
+					if (!m_writer_is_active.load()) {
+						return true;
+					}
+					count_ref.fetch_sub(1);
+					return false;
+				}
+				void unlock_shared() {
+					this_thread_slot().m_count.fetch_sub(1, std::memory_order_release);
+				}
+
+				/* The writer (which has already excluded other writers) announces itself, then checks the slots. */
+				void begin_write() {
+					m_writer_is_active.store(true);
+				}
+				bool readers_have_drained() const {
+					for (const auto& slot : m_slots) {
+						if (0 != slot.m_count.load()) {
+							return false;
+						}
+					}
+					return true;
+				}
+				void end_write() {
+					m_writer_is_active.store(false);
+				}
+
+				/* A thread's count of (recursive) read locks on this object. Recursive read locks don't touch the slots
+				(so that a thread that already holds a read lock never has to wait for a writer). */
+				int& this_thread_readlock_count_ref() {
+					auto& held_locks_ref = this_thread_held_locks();
+					for (auto& item : held_locks_ref) {
+						if (this == item.first) {
+							return item.second;
+						}
+					}
+					held_locks_ref.emplace_back(this, 0);
+					return held_locks_ref.back().second;
+				}
+				int this_thread_readlock_count() const {
+					for (const auto& item : this_thread_held_locks()) {
+						if (this == item.first) {
+							return item.second;
+						}
+					}
+					return 0;
+				}
+				void forget_this_thread_readlock_count() {
+					auto& held_locks_ref = this_thread_held_locks();
+					for (auto it = held_locks_ref.begin(); held_locks_ref.end() != it; it++) {
+						if (this == (*it).first) {
+							held_locks_ref.erase(it);
+							return;
+						}
+					}
+				}
+
+			private:
+				struct slot_type {
+					alignas(MSE_ASYNCSHARED_CACHE_LINE_SIZE) std::atomic<int> m_count{ 0 };
+				};
+
+				static size_t default_number_of_slots() {
+					size_t num_hardware_threads = std::thread::hardware_concurrency();
+					if (1 > num_hardware_threads) { num_hardware_threads = 1; }
+					size_t retval = 1;
+					while (num_hardware_threads > retval) {
+						retval <<= 1;
+					}
+					return retval;
+				}
+				slot_type& this_thread_slot() {
+					/* Threads are assigned slots in round-robin order. */
+					static std::atomic<size_t> s_next_thread_slot_index{ 0 };
+					thread_local size_t tl_thread_slot_index = s_next_thread_slot_index.fetch_add(1, std::memory_order_relaxed);
+					return m_slots[tl_thread_slot_index & m_slot_index_mask];
+				}
+				static std::vector<std::pair<const big_reader_indicators*, int>>& this_thread_held_locks() {
+					thread_local std::vector<std::pair<const big_reader_indicators*, int>> tl_held_locks;
+					return tl_held_locks;
+				}
+
+				std::vector<slot_type, TAsyncSharedCacheLineAlignedAllocator<slot_type>> m_slots;
+				const size_t m_slot_index_mask;
+				alignas(MSE_ASYNCSHARED_CACHE_LINE_SIZE) std::atomic<bool> m_writer_is_active{ false };
+			};
+		}
+	}
+
 	class recursive_shared_timed_mutex : private std::shared_timed_mutex {
 	public:
 		typedef std::shared_timed_mutex base_class;
@@ -76,6 +260,13 @@ namespace mse {
 				{
 					unlock_guard<std::mutex> unlock1(m_write_mutex);
 					base_class::lock();
+					if (m_big_reader_indicators_shptr) {
+						/* The underlying mutex only excludes other writers (and "slow path" readers). */
+						m_big_reader_indicators_shptr->begin_write();
+						while (!m_big_reader_indicators_shptr->readers_have_drained()) {
+							std::this_thread::yield();
+						}
+					}
 				}
 				m_writelock_thread_id = std::this_thread::get_id();
 				assert(0 == m_writelock_count);
@@ -93,8 +284,16 @@ namespace mse {
 				retval = true;
 			}
 			else {
-				assert(0 == m_writelock_count);
+				/* Another thread may currently hold the lock, so m_writelock_count is not necessarily zero here. */
 				retval = base_class::try_lock();
+				if (retval && m_big_reader_indicators_shptr) {
+					m_big_reader_indicators_shptr->begin_write();
+					if (!m_big_reader_indicators_shptr->readers_have_drained()) {
+						m_big_reader_indicators_shptr->end_write();
+						base_class::unlock();
+						retval = false;
+					}
+				}
 				if (retval) {
 					m_writelock_thread_id = std::this_thread::get_id();
 					m_writelock_count += 1;
@@ -122,6 +321,18 @@ namespace mse {
 			else {
 				assert(0 == m_writelock_count);
 				retval = base_class::try_lock_until(_Abs_time);
+				if (retval && m_big_reader_indicators_shptr) {
+					m_big_reader_indicators_shptr->begin_write();
+					while (!m_big_reader_indicators_shptr->readers_have_drained()) {
+						if (_Clock::now() >= _Abs_time) {
+							m_big_reader_indicators_shptr->end_write();
+							base_class::unlock();
+							retval = false;
+							break;
+						}
+						std::this_thread::yield();
+					}
+				}
 				if (retval) {
 					m_writelock_thread_id = std::this_thread::get_id();
 					m_writelock_count += 1;
@@ -139,6 +350,9 @@ namespace mse {
 			}
 			else {
 				assert(1 == m_writelock_count);
+				if (m_big_reader_indicators_shptr) {
+					m_big_reader_indicators_shptr->end_write();
+				}
 				base_class::unlock();
 			}
 			m_writelock_count -= 1;
@@ -146,6 +360,19 @@ namespace mse {
 
 		void lock_shared()
 		{	// lock non-exclusive
+			if (m_big_reader_indicators_shptr) {
+				auto& readlock_count_ref = m_big_reader_indicators_shptr->this_thread_readlock_count_ref();
+				if (0 == readlock_count_ref) {
+					while (!m_big_reader_indicators_shptr->try_lock_shared()) {
+						/* A writer is active. We wait for it to finish by (briefly) obtaining a read lock on the underlying
+						mutex. */
+						base_class::lock_shared();
+						base_class::unlock_shared();
+					}
+				}
+				readlock_count_ref += 1;
+				return;
+			}
 			std::lock_guard<std::mutex> lock1(m_read_mutex);
 
 			const auto this_thread_id = std::this_thread::get_id();
@@ -180,6 +407,15 @@ namespace mse {
 
 		bool try_lock_shared()
 		{	// try to lock non-exclusive
+			if (m_big_reader_indicators_shptr) {
+				auto& readlock_count_ref = m_big_reader_indicators_shptr->this_thread_readlock_count_ref();
+				if ((0 == readlock_count_ref) && (!m_big_reader_indicators_shptr->try_lock_shared())) {
+					m_big_reader_indicators_shptr->forget_this_thread_readlock_count();
+					return false;
+				}
+				readlock_count_ref += 1;
+				return true;
+			}
 			bool retval = false;
 			std::lock_guard<std::mutex> lock1(m_read_mutex);
 
@@ -220,6 +456,20 @@ namespace mse {
 		template<class _Clock, class _Duration>
 		bool try_lock_shared_until(const std::chrono::time_point<_Clock, _Duration>& _Abs_time)
 		{	// try to lock non-exclusive until absolute time
+			if (m_big_reader_indicators_shptr) {
+				auto& readlock_count_ref = m_big_reader_indicators_shptr->this_thread_readlock_count_ref();
+				if (0 == readlock_count_ref) {
+					while (!m_big_reader_indicators_shptr->try_lock_shared()) {
+						if (!base_class::try_lock_shared_until(_Abs_time)) {
+							m_big_reader_indicators_shptr->forget_this_thread_readlock_count();
+							return false;
+						}
+						base_class::unlock_shared();
+					}
+				}
+				readlock_count_ref += 1;
+				return true;
+			}
 			bool retval = false;
 			std::lock_guard<std::mutex> lock1(m_read_mutex);
 
@@ -253,6 +503,16 @@ namespace mse {
 
 		void unlock_shared()
 		{	// unlock non-exclusive
+			if (m_big_reader_indicators_shptr) {
+				auto& readlock_count_ref = m_big_reader_indicators_shptr->this_thread_readlock_count_ref();
+				assert(1 <= readlock_count_ref);
+				readlock_count_ref -= 1;
+				if (0 == readlock_count_ref) {
+					m_big_reader_indicators_shptr->forget_this_thread_readlock_count();
+					m_big_reader_indicators_shptr->unlock_shared();
+				}
+				return;
+			}
 			std::lock_guard<std::mutex> lock1(m_read_mutex);
 
 			const auto this_thread_id = std::this_thread::get_id();
@@ -276,13 +536,588 @@ namespace mse {
 		std::mutex m_write_mutex;
 		std::mutex m_read_mutex;
 
+		/* Switches the mutex to the "big reader" mode (see big_reader_indicators). Must be called before the mutex is
+		(concurrently) used. */
+		void enable_big_reader_mode() {
+			m_big_reader_indicators_shptr = std::allocate_shared<impl::asyncshared::big_reader_indicators>(
+				TAsyncSharedCacheLineAlignedAllocator<impl::asyncshared::big_reader_indicators>());
+		}
+		bool is_in_big_reader_mode() const { return bool(m_big_reader_indicators_shptr); }
+		int this_thread_readlock_count() {
+			if (m_big_reader_indicators_shptr) {
+				return m_big_reader_indicators_shptr->this_thread_readlock_count();
+			}
+			std::lock_guard<std::mutex> lock1(m_read_mutex);
+			const auto found_it = m_thread_id_readlock_count_map.find(std::this_thread::get_id());
+			return (m_thread_id_readlock_count_map.end() != found_it) ? (*found_it).second : 0;
+		}
+
 		std::thread::id m_writelock_thread_id;
 		int m_writelock_count = 0;
 		std::unordered_map<std::thread::id, int> m_thread_id_readlock_count_map;
+		std::shared_ptr<impl::asyncshared::big_reader_indicators> m_big_reader_indicators_shptr;
+	};
+
+	/* asyncshared_lock_stats accumulates lock contention statistics (for a shared object, or for a group of shared
+	objects sharing a name). Only "outermost" (i.e. non-recursive) lock acquisitions are counted. Wait and hold times
+	are recorded in histograms with logarithmic (power of two nanosecond) buckets. */
+	struct asyncshared_lock_stats_snapshot {
+		static const size_t number_of_histogram_buckets = 40;
+		typedef std::array<std::uint64_t, number_of_histogram_buckets> histogram_type;
+
+		/* Returns the lower bound (in nanoseconds) of the durations counted by the given histogram bucket. */
+		static std::uint64_t histogram_bucket_lower_bound_ns(size_t bucket_index) {
+			return (0 == bucket_index) ? 0 : (std::uint64_t(1) << bucket_index);
+		}
+		/* (Returns the number of writes if there were no reads.) */
+		double writer_to_reader_ratio() const {
+			return (0 == read_acquisition_count) ? double(write_acquisition_count) : double(write_acquisition_count) / double(read_acquisition_count);
+		}
+		std::uint64_t acquisition_count() const { return write_acquisition_count + read_acquisition_count; }
+		std::uint64_t contended_acquisition_count() const { return contended_write_acquisition_count + contended_read_acquisition_count; }
+
+		std::uint64_t write_acquisition_count = 0;
+		std::uint64_t read_acquisition_count = 0;
+		std::uint64_t contended_write_acquisition_count = 0;
+		std::uint64_t contended_read_acquisition_count = 0;
+		std::uint64_t failed_try_count = 0;
+		std::uint64_t total_wait_ns = 0;
+		std::uint64_t max_wait_ns = 0;
+		std::uint64_t total_hold_ns = 0;
+		std::uint64_t max_hold_ns = 0;
+		histogram_type wait_time_histogram{};
+		histogram_type hold_time_histogram{};
+	};
+
+	class asyncshared_lock_stats {
+	public:
+		static const size_t number_of_histogram_buckets = asyncshared_lock_stats_snapshot::number_of_histogram_buckets;
+
+		asyncshared_lock_stats() { reset(); }
+
+		void record_acquisition(bool is_write, bool was_contended, std::chrono::nanoseconds wait_time) {
+			(is_write ? m_write_acquisition_count : m_read_acquisition_count).fetch_add(1, std::memory_order_relaxed);
+			if (was_contended) {
+				(is_write ? m_contended_write_acquisition_count : m_contended_read_acquisition_count).fetch_add(1, std::memory_order_relaxed);
+			}
+			record_duration(wait_time, m_total_wait_ns, m_max_wait_ns, m_wait_time_histogram);
+		}
+		void record_failed_try() {
+			m_failed_try_count.fetch_add(1, std::memory_order_relaxed);
+		}
+		void record_release(std::chrono::nanoseconds hold_time) {
+			record_duration(hold_time, m_total_hold_ns, m_max_hold_ns, m_hold_time_histogram);
+		}
+
+		asyncshared_lock_stats_snapshot snapshot() const {
+			asyncshared_lock_stats_snapshot retval;
+			retval.write_acquisition_count = m_write_acquisition_count.load(std::memory_order_relaxed);
+			retval.read_acquisition_count = m_read_acquisition_count.load(std::memory_order_relaxed);
+			retval.contended_write_acquisition_count = m_contended_write_acquisition_count.load(std::memory_order_relaxed);
+			retval.contended_read_acquisition_count = m_contended_read_acquisition_count.load(std::memory_order_relaxed);
+			retval.failed_try_count = m_failed_try_count.load(std::memory_order_relaxed);
+			retval.total_wait_ns = m_total_wait_ns.load(std::memory_order_relaxed);
+			retval.max_wait_ns = m_max_wait_ns.load(std::memory_order_relaxed);
+			retval.total_hold_ns = m_total_hold_ns.load(std::memory_order_relaxed);
+			retval.max_hold_ns = m_max_hold_ns.load(std::memory_order_relaxed);
+			for (size_t i = 0; number_of_histogram_buckets > i; i += 1) {
+				retval.wait_time_histogram[i] = m_wait_time_histogram[i].load(std::memory_order_relaxed);
+				retval.hold_time_histogram[i] = m_hold_time_histogram[i].load(std::memory_order_relaxed);
+			}
+			return retval;
+		}
+		void reset() {
+			m_write_acquisition_count.store(0); m_read_acquisition_count.store(0);
+			m_contended_write_acquisition_count.store(0); m_contended_read_acquisition_count.store(0);
+			m_failed_try_count.store(0);
+			m_total_wait_ns.store(0); m_max_wait_ns.store(0);
+			m_total_hold_ns.store(0); m_max_hold_ns.store(0);
+			for (size_t i = 0; number_of_histogram_buckets > i; i += 1) {
+				m_wait_time_histogram[i].store(0);
+				m_hold_time_histogram[i].store(0);
+			}
+		}
+
+	private:
+		typedef std::array<std::atomic<std::uint64_t>, number_of_histogram_buckets> atomic_histogram_type;
+
+		static size_t histogram_bucket_index(std::uint64_t ns) {
+			size_t retval = 0;
+			while ((1 < ns) && (number_of_histogram_buckets - 1 > retval)) {
+				ns >>= 1;
+				retval += 1;
+			}
+			return retval;
+		}
+		static void record_duration(std::chrono::nanoseconds duration, std::atomic<std::uint64_t>& total_ns, std::atomic<std::uint64_t>& max_ns, atomic_histogram_type& histogram) {
+			const std::uint64_t ns = (0 < duration.count()) ? std::uint64_t(duration.count()) : 0;
+			total_ns.fetch_add(ns, std::memory_order_relaxed);
+			auto prev_max_ns = max_ns.load(std::memory_order_relaxed);
+			while ((prev_max_ns < ns) && (!max_ns.compare_exchange_weak(prev_max_ns, ns, std::memory_order_relaxed))) {}
+			histogram[histogram_bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+		}
+
+		std::atomic<std::uint64_t> m_write_acquisition_count;
+		std::atomic<std::uint64_t> m_read_acquisition_count;
+		std::atomic<std::uint64_t> m_contended_write_acquisition_count;
+		std::atomic<std::uint64_t> m_contended_read_acquisition_count;
+		std::atomic<std::uint64_t> m_failed_try_count;
+		std::atomic<std::uint64_t> m_total_wait_ns;
+		std::atomic<std::uint64_t> m_max_wait_ns;
+		std::atomic<std::uint64_t> m_total_hold_ns;
+		std::atomic<std::uint64_t> m_max_hold_ns;
+		atomic_histogram_type m_wait_time_histogram;
+		atomic_histogram_type m_hold_time_histogram;
+	};
+
+	/* asyncshared_lock_stats_registry is the process-wide collection of (named) lock contention statistics. When
+	MSE_ASYNCSHARED_LOCK_STATS_ENABLED is defined, each asynchronously shared object records its statistics under the
+	name of its type, unless it has been given a name of its own (via its access requester's set_lock_stats_name()).
+	Objects with the same name share (i.e. aggregate) their statistics. */
+	class asyncshared_lock_stats_registry {
+	public:
+		typedef std::vector<std::pair<std::string, asyncshared_lock_stats_snapshot>> snapshot_type;
+
+		static asyncshared_lock_stats_registry& global() {
+			static asyncshared_lock_stats_registry s_registry;
+			return s_registry;
+		}
+
+		std::shared_ptr<asyncshared_lock_stats> stats(const std::string& name) {
+			std::lock_guard<std::mutex> lock1(m_mutex);
+			auto& stats_shptr_ref = m_name_to_stats_map[name];
+			if (!stats_shptr_ref) {
+				stats_shptr_ref = std::make_shared<asyncshared_lock_stats>();
+			}
+			return stats_shptr_ref;
+		}
+		/* Returns the statistics of each name, ordered by name. */
+		snapshot_type snapshot() const {
+			snapshot_type retval;
+			std::lock_guard<std::mutex> lock1(m_mutex);
+			for (const auto& item : m_name_to_stats_map) {
+				retval.emplace_back(item.first, item.second->snapshot());
+			}
+			return retval;
+		}
+		void reset() {
+			std::lock_guard<std::mutex> lock1(m_mutex);
+			for (auto& item : m_name_to_stats_map) {
+				item.second->reset();
+			}
+		}
+
+		std::string to_text() const {
+			std::ostringstream sstream;
+			for (const auto& item : snapshot()) {
+				const auto& stats = item.second;
+				sstream << item.first << ":\n";
+				sstream << "  acquisitions: " << stats.acquisition_count() << " (writes: " << stats.write_acquisition_count
+					<< ", reads: " << stats.read_acquisition_count << ", writer/reader ratio: " << stats.writer_to_reader_ratio() << ")\n";
+				sstream << "  contended acquisitions: " << stats.contended_acquisition_count() << " (writes: " << stats.contended_write_acquisition_count
+					<< ", reads: " << stats.contended_read_acquisition_count << "), failed tries: " << stats.failed_try_count << "\n";
+				const auto num_acquisitions = (0 == stats.acquisition_count()) ? 1 : stats.acquisition_count();
+				sstream << "  wait ns: mean " << (stats.total_wait_ns / num_acquisitions) << ", max " << stats.max_wait_ns << "\n";
+				sstream << "  hold ns: mean " << (stats.total_hold_ns / num_acquisitions) << ", max " << stats.max_hold_ns << "\n";
+				histogram_to_text(sstream, "  wait histogram (ns >= : count):", stats.wait_time_histogram);
+				histogram_to_text(sstream, "  hold histogram (ns >= : count):", stats.hold_time_histogram);
+			}
+			return sstream.str();
+		}
+		std::string to_json() const {
+			std::ostringstream sstream;
+			sstream << "{";
+			bool is_first = true;
+			for (const auto& item : snapshot()) {
+				const auto& stats = item.second;
+				sstream << (is_first ? "" : ",") << "\n  \"" << json_escaped(item.first) << "\": {";
+				is_first = false;
+				sstream << "\"write_acquisitions\": " << stats.write_acquisition_count;
+				sstream << ", \"read_acquisitions\": " << stats.read_acquisition_count;
+				sstream << ", \"contended_write_acquisitions\": " << stats.contended_write_acquisition_count;
+				sstream << ", \"contended_read_acquisitions\": " << stats.contended_read_acquisition_count;
+				sstream << ", \"failed_tries\": " << stats.failed_try_count;
+				sstream << ", \"writer_to_reader_ratio\": " << stats.writer_to_reader_ratio();
+				sstream << ", \"total_wait_ns\": " << stats.total_wait_ns << ", \"max_wait_ns\": " << stats.max_wait_ns;
+				sstream << ", \"total_hold_ns\": " << stats.total_hold_ns << ", \"max_hold_ns\": " << stats.max_hold_ns;
+				sstream << ", \"wait_histogram\": ";
+				histogram_to_json(sstream, stats.wait_time_histogram);
+				sstream << ", \"hold_histogram\": ";
+				histogram_to_json(sstream, stats.hold_time_histogram);
+				sstream << "}";
+			}
+			sstream << "\n}\n";
+			return sstream.str();
+		}
+
+	private:
+		asyncshared_lock_stats_registry() {}
+
+		static void histogram_to_text(std::ostream& ostream, const char* heading, const asyncshared_lock_stats_snapshot::histogram_type& histogram) {
+			ostream << heading;
+			for (size_t i = 0; histogram.size() > i; i += 1) {
+				if (0 != histogram[i]) {
+					ostream << " " << asyncshared_lock_stats_snapshot::histogram_bucket_lower_bound_ns(i) << ": " << histogram[i] << ",";
+				}
+			}
+			ostream << "\n";
+		}
+		/* Only the non-empty buckets are included, as {"ns": <bucket lower bound>, "count": <count>} objects. */
+		static void histogram_to_json(std::ostream& ostream, const asyncshared_lock_stats_snapshot::histogram_type& histogram) {
+			ostream << "[";
+			bool is_first = true;
+			for (size_t i = 0; histogram.size() > i; i += 1) {
+				if (0 != histogram[i]) {
+					ostream << (is_first ? "" : ", ") << "{\"ns\": " << asyncshared_lock_stats_snapshot::histogram_bucket_lower_bound_ns(i) << ", \"count\": " << histogram[i] << "}";
+					is_first = false;
+				}
+			}
+			ostream << "]";
+		}
+		static std::string json_escaped(const std::string& str) {
+			std::string retval;
+			for (const auto ch : str) {
+				if (('"' == ch) || ('\\' == ch)) {
+					retval += '\\';
+					retval += ch;
+				}
+				else if (0x20 > static_cast<unsigned char>(ch)) {
+					static const char hex_digits[] = "0123456789abcdef";
+					retval += "\\u00";
+					retval += hex_digits[(ch >> 4) & 0xf];
+					retval += hex_digits[ch & 0xf];
+				}
+				else {
+					retval += ch;
+				}
+			}
+			return retval;
+		}
+
+		mutable std::mutex m_mutex;
+		std::map<std::string, std::shared_ptr<asyncshared_lock_stats>> m_name_to_stats_map;
+	};
+
+	/* instrumented_recursive_shared_timed_mutex is the version of recursive_shared_timed_mutex used (when
+	MSE_ASYNCSHARED_LOCK_STATS_ENABLED is defined) to record lock contention statistics. An acquisition is considered
+	"contended" if the lock was not immediately available. */
+	class instrumented_recursive_shared_timed_mutex : public recursive_shared_timed_mutex {
+	public:
+		typedef recursive_shared_timed_mutex base_class;
+		typedef std::chrono::steady_clock clock_type;
+
+		instrumented_recursive_shared_timed_mutex(std::shared_ptr<asyncshared_lock_stats> stats_shptr = asyncshared_lock_stats_registry::global().stats("(unnamed)"))
+			: m_stats_shptr(stats_shptr) {}
+
+		std::shared_ptr<asyncshared_lock_stats> stats() const { return std::atomic_load(&m_stats_shptr); }
+		void set_stats(std::shared_ptr<asyncshared_lock_stats> stats_shptr) { std::atomic_store(&m_stats_shptr, stats_shptr); }
+
+		void lock() {
+			const auto start_time = clock_type::now();
+			bool was_contended = false;
+			if (!base_class::try_lock()) {
+				was_contended = true;
+				base_class::lock();
+			}
+			note_write_acquisition(was_contended, start_time);
+		}
+		bool try_lock() {
+			const auto start_time = clock_type::now();
+			const auto retval = base_class::try_lock();
+			if (retval) {
+				note_write_acquisition(false, start_time);
+			}
+			else {
+				stats()->record_failed_try();
+			}
+			return retval;
+		}
+		template<class _Rep, class _Period>
+		bool try_lock_for(const std::chrono::duration<_Rep, _Period>& _Rel_time) {
+			return (try_lock_until(std::chrono::steady_clock::now() + _Rel_time));
+		}
+		template<class _Clock, class _Duration>
+		bool try_lock_until(const std::chrono::time_point<_Clock, _Duration>& _Abs_time) {
+			const auto start_time = clock_type::now();
+			bool was_contended = false;
+			bool retval = base_class::try_lock();
+			if (!retval) {
+				was_contended = true;
+				retval = base_class::try_lock_until(_Abs_time);
+			}
+			if (retval) {
+				note_write_acquisition(was_contended, start_time);
+			}
+			else {
+				stats()->record_failed_try();
+			}
+			return retval;
+		}
+		void unlock() {
+			if (1 == m_writelock_count) {
+				stats()->record_release(clock_type::now() - m_writelock_acquired_time);
+			}
+			base_class::unlock();
+		}
+
+		void lock_shared() {
+			const auto start_time = clock_type::now();
+			bool was_contended = false;
+			if (!base_class::try_lock_shared()) {
+				was_contended = true;
+				base_class::lock_shared();
+			}
+			note_read_acquisition(was_contended, start_time);
+		}
+		bool try_lock_shared() {
+			const auto start_time = clock_type::now();
+			const auto retval = base_class::try_lock_shared();
+			if (retval) {
+				note_read_acquisition(false, start_time);
+			}
+			else {
+				stats()->record_failed_try();
+			}
+			return retval;
+		}
+		template<class _Rep, class _Period>
+		bool try_lock_shared_for(const std::chrono::duration<_Rep, _Period>& _Rel_time) {
+			return (try_lock_shared_until(_Rel_time + std::chrono::steady_clock::now()));
+		}
+		template<class _Clock, class _Duration>
+		bool try_lock_shared_until(const std::chrono::time_point<_Clock, _Duration>& _Abs_time) {
+			const auto start_time = clock_type::now();
+			bool was_contended = false;
+			bool retval = base_class::try_lock_shared();
+			if (!retval) {
+				was_contended = true;
+				retval = base_class::try_lock_shared_until(_Abs_time);
+			}
+			if (retval) {
+				note_read_acquisition(was_contended, start_time);
+			}
+			else {
+				stats()->record_failed_try();
+			}
+			return retval;
+		}
+		void unlock_shared() {
+			if (1 == this_thread_readlock_count()) {
+				std::lock_guard<std::mutex> lock1(m_read_mutex);
+				const auto acquired_time_found_it = m_thread_id_readlock_acquired_time_map.find(std::this_thread::get_id());
+				if (m_thread_id_readlock_acquired_time_map.end() != acquired_time_found_it) {
+					stats()->record_release(clock_type::now() - (*acquired_time_found_it).second);
+					m_thread_id_readlock_acquired_time_map.erase(acquired_time_found_it);
+				}
+			}
+			base_class::unlock_shared();
+		}
+
+	private:
+		/* These are called while the lock is held. */
+		void note_write_acquisition(bool was_contended, clock_type::time_point start_time) {
+			if (1 == m_writelock_count) {
+				const auto now = clock_type::now();
+				m_writelock_acquired_time = now;
+				stats()->record_acquisition(true, was_contended, now - start_time);
+			}
+		}
+		void note_read_acquisition(bool was_contended, clock_type::time_point start_time) {
+			if (1 == this_thread_readlock_count()) {
+				std::lock_guard<std::mutex> lock1(m_read_mutex);
+				const auto this_thread_id = std::this_thread::get_id();
+				const auto now = clock_type::now();
+				m_thread_id_readlock_acquired_time_map[this_thread_id] = now;
+				stats()->record_acquisition(false, was_contended, now - start_time);
+			}
+		}
+
+		std::shared_ptr<asyncshared_lock_stats> m_stats_shptr;
+		clock_type::time_point m_writelock_acquired_time;
+		std::unordered_map<std::thread::id, clock_type::time_point> m_thread_id_readlock_acquired_time_map;
 	};
 
 	//typedef std::shared_timed_mutex async_shared_timed_mutex_type;
+#ifdef MSE_ASYNCSHARED_LOCK_STATS_ENABLED
+	typedef instrumented_recursive_shared_timed_mutex async_shared_timed_mutex_type;
+#else // MSE_ASYNCSHARED_LOCK_STATS_ENABLED
 	typedef recursive_shared_timed_mutex async_shared_timed_mutex_type;
+#endif // MSE_ASYNCSHARED_LOCK_STATS_ENABLED
+
+	/* asyncshared_waiter_list holds the (asynchronous) lock requests that are waiting for a shared object's lock to be
+	released. Each waiter is just a function that re-submits the request to its (caller supplied) executor. */
+	class asyncshared_waiter_list {
+	public:
+		/* Calls try_lock_function() and, if it fails to obtain the lock, registers the given waiter to be called upon the
+		next release of the lock. The try and the registration are done atomically with respect to notify(), so a
+		release that occurs between the two can't be "missed". */
+		template<class _TTryLockFunction>
+		auto try_lock_or_enqueue(_TTryLockFunction& try_lock_function, std::function<void()> waiter) -> decltype(try_lock_function()) {
+			std::lock_guard<std::mutex> lock1(m_mutex);
+			m_num_waiters.fetch_add(1);
+			auto retval = try_lock_function();
+			if (retval) {
+				m_num_waiters.fetch_sub(1);
+			}
+			else {
+				m_waiters.push_back(std::move(waiter));
+			}
+			return retval;
+		}
+		/* To be called after the lock has been released. */
+		void notify() {
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (0 == m_num_waiters.load()) {
+				/* The common case. */
+				return;
+			}
+			std::vector<std::function<void()>> waiters;
+			{
+				std::lock_guard<std::mutex> lock1(m_mutex);
+				std::swap(waiters, m_waiters);
+				m_num_waiters.fetch_sub(int(waiters.size()));
+			}
+			for (auto& waiter : waiters) {
+				waiter();
+			}
+		}
+
+	private:
+		std::atomic<int> m_num_waiters{ 0 };
+		std::mutex m_mutex;
+		std::vector<std::function<void()>> m_waiters;
+	};
+
+	namespace impl {
+		namespace asyncshared {
+			template<class _TResult>
+			struct invoke_and_set_promise_value {
+				template<class _TFunction, class _TPointer>
+				static void invoke(std::promise<_TResult>& promise, _TFunction& function, _TPointer&& pointer) {
+					promise.set_value(function(std::forward<_TPointer>(pointer)));
+				}
+			};
+			template<>
+			struct invoke_and_set_promise_value<void> {
+				template<class _TFunction, class _TPointer>
+				static void invoke(std::promise<void>& promise, _TFunction& function, _TPointer&& pointer) {
+					function(std::forward<_TPointer>(pointer));
+					promise.set_value();
+				}
+			};
+
+			/* TAsyncLockTask carries out an asynchronous lock request. It runs (only) on the given executor, where it
+			attempts to obtain the lock. If unsuccessful, it registers itself to be re-submitted to the executor upon the
+			next release of the lock, rather than blocking. When successful, it passes the lock holding pointer to the
+			given function, the result of which is delivered via an std::future. */
+			template<class _TTryLockFunction, class _TExecutor, class _TFunction, class _TResult>
+			class TAsyncLockTask : public std::enable_shared_from_this<TAsyncLockTask<_TTryLockFunction, _TExecutor, _TFunction, _TResult>> {
+			public:
+				TAsyncLockTask(const _TTryLockFunction& try_lock_function, asyncshared_waiter_list& waiter_list_ref, const _TExecutor& executor, const _TFunction& function)
+					: m_try_lock_function(try_lock_function), m_waiter_list_ptr(&waiter_list_ref), m_executor(executor), m_function(function) {}
+
+				std::future<_TResult> get_future() { return m_promise.get_future(); }
+				void submit() {
+					auto shptr = this->shared_from_this();
+					m_executor([shptr]() { shptr->run(); });
+				}
+				void run() {
+					try {
+						auto shptr = this->shared_from_this();
+						auto maybe_lock_ptr = (*m_waiter_list_ptr).try_lock_or_enqueue(m_try_lock_function, [shptr]() { shptr->submit(); });
+						if (maybe_lock_ptr) {
+							invoke_and_set_promise_value<_TResult>::invoke(m_promise, m_function, std::move(*maybe_lock_ptr));
+						}
+					}
+					catch (...) {
+						m_promise.set_exception(std::current_exception());
+					}
+				}
+
+			private:
+				_TTryLockFunction m_try_lock_function;
+				/* The target object (and so its waiter list) is kept alive by the access requester held by
+				m_try_lock_function. */
+				asyncshared_waiter_list* m_waiter_list_ptr = nullptr;
+				_TExecutor m_executor;
+				_TFunction m_function;
+				std::promise<_TResult> m_promise;
+			};
+
+			template<class _TPointer, class _TTryLockFunction, class _TExecutor, class _TFunction>
+			auto async_lock(const _TTryLockFunction& try_lock_function, asyncshared_waiter_list& waiter_list_ref, const _TExecutor& executor, const _TFunction& function)
+				-> std::future<decltype(function(std::declval<_TPointer>()))> {
+				typedef decltype(function(std::declval<_TPointer>())) result_type;
+				auto task_shptr = std::make_shared<TAsyncLockTask<_TTryLockFunction, _TExecutor, _TFunction, result_type>>(try_lock_function, waiter_list_ref, executor, function);
+				auto retval = task_shptr->get_future();
+				task_shptr->submit();
+				return retval;
+			}
+		}
+	}
+
+	namespace impl {
+		namespace asyncshared {
+			/* TPendingUpdateList is the "publication list" used for "flat combining". It's a lock-free stack of update
+			functions that have been posted (by any thread) but not yet applied to the shared object. */
+			template<typename _Ty>
+			class TPendingUpdateList {
+			public:
+				typedef std::function<void(_Ty&)> update_function_type;
+
+				TPendingUpdateList() {}
+				TPendingUpdateList(const TPendingUpdateList&) = delete;
+				~TPendingUpdateList() {
+					delete_nodes(m_head.exchange(nullptr));
+				}
+
+				void push(update_function_type function) {
+					auto node_ptr = new node_type(std::move(function));
+					node_ptr->m_next_ptr = m_head.load(std::memory_order_relaxed);
+					while (!m_head.compare_exchange_weak(node_ptr->m_next_ptr, node_ptr)) {}
+				}
+				bool empty() const {
+					return (nullptr == m_head.load());
+				}
+				/* Removes all the pending updates and applies them (in the order they were posted) to the given target. The
+				update functions are not permitted to throw (as they may be applied in the context of another thread's
+				lock pointer destructor). */
+				void apply_all(_Ty& target) noexcept {
+					node_type* reversed_head_ptr = nullptr;
+					auto node_ptr = m_head.exchange(nullptr);
+					while (node_ptr) {
+						auto next_ptr = node_ptr->m_next_ptr;
+						node_ptr->m_next_ptr = reversed_head_ptr;
+						reversed_head_ptr = node_ptr;
+						node_ptr = next_ptr;
+					}
+					node_ptr = reversed_head_ptr;
+					while (node_ptr) {
+						node_ptr->m_function(target);
+						auto next_ptr = node_ptr->m_next_ptr;
+						delete node_ptr;
+						node_ptr = next_ptr;
+					}
+				}
+
+			private:
+				struct node_type {
+					node_type(update_function_type&& function) : m_function(std::move(function)) {}
+					update_function_type m_function;
+					node_type* m_next_ptr = nullptr;
+				};
+				static void delete_nodes(node_type* node_ptr) {
+					while (node_ptr) {
+						auto next_ptr = node_ptr->m_next_ptr;
+						delete node_ptr;
+						node_ptr = next_ptr;
+					}
+				}
+
+				std::atomic<node_type*> m_head{ nullptr };
+			};
+		}
+	}
 
 	template<typename _Ty> class TAsyncSharedReadWriteAccessRequester;
 	template<typename _Ty> class TAsyncSharedReadWritePointer;
@@ -295,12 +1130,18 @@ namespace mse {
 	template<typename _Ty> class TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteConstPointer;
 	template<typename _Ty> class TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyAccessRequester;
 	template<typename _Ty> class TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer;
+	class asyncshared_task_access;
 
 	/* TAsyncSharedObj is intended as a transparent wrapper for other classes/objects. */
 	template<typename _TROy>
 	class TAsyncSharedObj : public _TROy {
 	public:
 		MSE_ASYNC_USING(TAsyncSharedObj, _TROy);
+		/* Constructs the object with its lock in the "big reader" mode. */
+		template<typename ...Args>
+		TAsyncSharedObj(const asyncshared_big_reader_lock_mode_t&, Args&&... args) : _TROy(std::forward<Args>(args)...) {
+			m_mutex1.enable_big_reader_mode();
+		}
 		virtual ~TAsyncSharedObj() {}
 		using _TROy::operator=;
 		//TAsyncSharedObj& operator=(TAsyncSharedObj&& _X) { _TROy::operator=(std::move(_X)); return (*this); }
@@ -320,7 +1161,47 @@ namespace mse {
 			return this;
 		}
 
-		mutable async_shared_timed_mutex_type m_mutex1;
+		/* The (frequently modified) lock state is aligned to its own cache line(s) so that it doesn't "false share" with
+		the payload object. (The alignment also pads the end of the object to a cache line boundary.) */
+#ifdef MSE_ASYNCSHARED_LOCK_STATS_ENABLED
+		/* By default, lock contention statistics are aggregated by (shared object) type. */
+		alignas(MSE_ASYNCSHARED_CACHE_LINE_SIZE) mutable async_shared_timed_mutex_type m_mutex1{ asyncshared_lock_stats_registry::global().stats(typeid(_TROy).name()) };
+#else // MSE_ASYNCSHARED_LOCK_STATS_ENABLED
+		alignas(MSE_ASYNCSHARED_CACHE_LINE_SIZE) mutable async_shared_timed_mutex_type m_mutex1;
+#endif // MSE_ASYNCSHARED_LOCK_STATS_ENABLED
+		mutable asyncshared_waiter_list m_async_waiters;
+		mutable impl::asyncshared::TPendingUpdateList<_TROy> m_pending_updates;
+
+		/* To be called (by the lock pointers) after a lock on the object has been released. */
+		void note_lock_released() const {
+			m_async_waiters.notify();
+			apply_pending_updates();
+		}
+		/* "Flat combining": The update is posted to the object's list of pending updates, after which, whichever thread
+		holds (or next releases) a lock on the object applies all the pending updates as a batch. If no thread holds a
+		lock, the calling thread applies them. */
+		void post_update(typename impl::asyncshared::TPendingUpdateList<_TROy>::update_function_type function) const {
+			m_pending_updates.push(std::move(function));
+			apply_pending_updates();
+		}
+		/* A posted update is guaranteed to be applied because, after posting, the posting thread attempts to obtain the
+		lock, and every release of the lock is followed by a check for pending updates. (The fences ensure that at least
+		one of the two observes the other.) */
+		void apply_pending_updates() const {
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			while (!m_pending_updates.empty()) {
+				if (!m_mutex1.try_lock()) {
+					/* Whichever thread holds the lock will apply the pending updates when it releases it. */
+					return;
+				}
+				/* Updates are only ever posted by (read-write) access requesters, which only target objects that were
+				not created const. */
+				m_pending_updates.apply_all(const_cast<_TROy&>(static_cast<const _TROy&>(*this)));
+				m_mutex1.unlock();
+				m_async_waiters.notify();
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+			}
+		}
 
 		friend class TAsyncSharedReadWriteAccessRequester<_TROy>;
 		friend class TAsyncSharedReadWritePointer<_TROy>;
@@ -335,6 +1216,20 @@ namespace mse {
 		friend class TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer<_TROy>;
 	};
 
+	namespace impl {
+		namespace asyncshared {
+			/* The shared object and its std::shared_ptr "control block" (reference counts) are obtained in a single
+			allocation. The allocation is cache line aligned, so that the (frequently modified) reference counts, payload
+			object and lock state each start on their own cache line and don't share one with unrelated data. */
+			template<typename _Ty, class _TAllocator, class... Args>
+			std::shared_ptr<TAsyncSharedObj<_Ty>> allocate_shared_obj(const _TAllocator& allocator, Args&&... args) {
+				typedef typename std::allocator_traits<_TAllocator>::template rebind_alloc<TAsyncSharedObj<_Ty>> base_allocator_type;
+				typedef TAsyncSharedCacheLineAlignedAllocator<TAsyncSharedObj<_Ty>, base_allocator_type> allocator_type;
+				return std::allocate_shared<TAsyncSharedObj<_Ty>>(allocator_type(base_allocator_type(allocator)), std::forward<Args>(args)...);
+			}
+		}
+	}
+
 
 	template<typename _Ty> class TAsyncSharedReadWriteConstPointer;
 
@@ -343,7 +1238,14 @@ namespace mse {
 	public:
 		TAsyncSharedReadWritePointer(const TAsyncSharedReadWritePointer& src) : m_shptr(src.m_shptr), m_unique_lock(src.m_shptr->m_mutex1) {}
 		TAsyncSharedReadWritePointer(TAsyncSharedReadWritePointer&& src) = default;
-		virtual ~TAsyncSharedReadWritePointer() {}
+		virtual ~TAsyncSharedReadWritePointer() {
+			if (m_unique_lock.owns_lock()) {
+				/* The lock is released before notifying any asynchronous waiters (or flat combining updaters) so that they can
+				obtain it. */
+				m_unique_lock.unlock();
+				m_shptr->note_lock_released();
+			}
+		}
 
 		operator bool() const {
 			//assert(is_valid()); //{ MSE_THROW(asyncshared_use_of_invalid_pointer_error("attempt to use invalid pointer - mse::TAsyncSharedReadWritePointer")); }
@@ -363,19 +1265,19 @@ namespace mse {
 		TAsyncSharedReadWritePointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr) : m_shptr(shptr), m_unique_lock(shptr->m_mutex1) {}
 		TAsyncSharedReadWritePointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t) : m_shptr(shptr), m_unique_lock(shptr->m_mutex1, std::defer_lock) {
 			if (!m_unique_lock.try_lock()) {
-				shptr = nullptr;
+				m_shptr = nullptr;
 			}
 		}
 		template<class _Rep, class _Period>
 		TAsyncSharedReadWritePointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t, const std::chrono::duration<_Rep, _Period>& _Rel_time) : m_shptr(shptr), m_unique_lock(shptr->m_mutex1, std::defer_lock) {
 			if (!m_unique_lock.try_lock_for(_Rel_time)) {
-				shptr = nullptr;
+				m_shptr = nullptr;
 			}
 		}
 		template<class _Clock, class _Duration>
 		TAsyncSharedReadWritePointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t, const std::chrono::time_point<_Clock, _Duration>& _Abs_time) : m_shptr(shptr), m_unique_lock(shptr->m_mutex1, std::defer_lock) {
 			if (!m_unique_lock.try_lock_until(_Abs_time)) {
-				shptr = nullptr;
+				m_shptr = nullptr;
 			}
 		}
 		TAsyncSharedReadWritePointer<_Ty>& operator=(const TAsyncSharedReadWritePointer<_Ty>& _Right_cref) = delete;
@@ -401,7 +1303,12 @@ namespace mse {
 		TAsyncSharedReadWriteConstPointer(const TAsyncSharedReadWriteConstPointer& src) : m_shptr(src.m_shptr), m_unique_lock(src.m_shptr->m_mutex1) {}
 		TAsyncSharedReadWriteConstPointer(TAsyncSharedReadWriteConstPointer&& src) = default;
 		TAsyncSharedReadWriteConstPointer(const TAsyncSharedReadWritePointer<_Ty>& src) : m_shptr(src.m_shptr), m_unique_lock(src.m_shptr->m_mutex1) {}
-		virtual ~TAsyncSharedReadWriteConstPointer() {}
+		virtual ~TAsyncSharedReadWriteConstPointer() {
+			if (m_unique_lock.owns_lock()) {
+				m_unique_lock.unlock();
+				m_shptr->note_lock_released();
+			}
+		}
 
 		operator bool() const {
 			//assert(is_valid()); //{ MSE_THROW(asyncshared_use_of_invalid_pointer_error("attempt to use invalid pointer - mse::TAsyncSharedReadWriteConstPointer")); }
@@ -421,19 +1328,19 @@ namespace mse {
 		TAsyncSharedReadWriteConstPointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr) : m_shptr(shptr), m_unique_lock(shptr->m_mutex1) {}
 		TAsyncSharedReadWriteConstPointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t) : m_shptr(shptr), m_unique_lock(shptr->m_mutex1, std::defer_lock) {
 			if (!m_unique_lock.try_lock()) {
-				shptr = nullptr;
+				m_shptr = nullptr;
 			}
 		}
 		template<class _Rep, class _Period>
 		TAsyncSharedReadWriteConstPointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t, const std::chrono::duration<_Rep, _Period>& _Rel_time) : m_shptr(shptr), m_unique_lock(shptr->m_mutex1, std::defer_lock) {
 			if (!m_unique_lock.try_lock_for(_Rel_time)) {
-				shptr = nullptr;
+				m_shptr = nullptr;
 			}
 		}
 		template<class _Clock, class _Duration>
 		TAsyncSharedReadWriteConstPointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t, const std::chrono::time_point<_Clock, _Duration>& _Abs_time) : m_shptr(shptr), m_unique_lock(shptr->m_mutex1, std::defer_lock) {
 			if (!m_unique_lock.try_lock_until(_Abs_time)) {
-				shptr = nullptr;
+				m_shptr = nullptr;
 			}
 		}
 		TAsyncSharedReadWriteConstPointer<_Ty>& operator=(const TAsyncSharedReadWriteConstPointer<_Ty>& _Right_cref) = delete;
@@ -510,10 +1417,54 @@ namespace mse {
 			return retval;
 		}
 
+		/* async_writelock_ptr() and async_readlock_ptr() do not block the calling thread. The given function is called (on a thread of the given
+		executor) with the lock holding pointer once the lock has been obtained. Rather than blocking a thread while the lock
+		is unavailable, the request is re-submitted to the executor when the lock is released. The executor can be any
+		copyable callable object that accepts an std::function<void()>. The return value of the function is delivered via
+		the returned std::future. */
+		template<class _TExecutor, class _TFunction>
+		auto async_writelock_ptr(const _TExecutor& executor, const _TFunction& function)
+			-> std::future<decltype(function(std::declval<TAsyncSharedReadWritePointer<_Ty>>()))> {
+			auto requester = (*this);
+			auto try_lock_function = [requester]() mutable { return requester.try_writelock_ptr(); };
+			return impl::asyncshared::async_lock<TAsyncSharedReadWritePointer<_Ty>>(try_lock_function, m_shptr->m_async_waiters, executor, function);
+		}
+		template<class _TExecutor, class _TFunction>
+		auto async_readlock_ptr(const _TExecutor& executor, const _TFunction& function)
+			-> std::future<decltype(function(std::declval<TAsyncSharedReadWriteConstPointer<_Ty>>()))> {
+			auto requester = (*this);
+			auto try_lock_function = [requester]() mutable { return requester.try_readlock_ptr(); };
+			return impl::asyncshared::async_lock<TAsyncSharedReadWriteConstPointer<_Ty>>(try_lock_function, m_shptr->m_async_waiters, executor, function);
+		}
+
+		/* apply_async() posts the given function (which takes a (non-const) reference to the shared object) to be
+		applied to the shared object without waiting for the lock. If the lock is available, the calling thread applies
+		it (along with any other pending updates) immediately. Otherwise, the thread that holds the lock applies all the
+		pending updates (as a batch) when it releases the lock. This "flat combining" can greatly improve the throughput
+		of small, frequent updates (to counters and the like) from many threads. Note that the function is not permitted
+		to throw, and that it may be executed in another thread. */
+		template<class _TFunction>
+		void apply_async(const _TFunction& function) {
+			m_shptr->post_update(function);
+		}
+		/* When MSE_ASYNCSHARED_LOCK_STATS_ENABLED is defined, this causes the shared object's lock contention statistics
+		to be recorded (in asyncshared_lock_stats_registry::global()) under the given name, rather than under the name of
+		its type. Otherwise it does nothing. */
+		void set_lock_stats_name(const std::string& name) {
+#ifdef MSE_ASYNCSHARED_LOCK_STATS_ENABLED
+			m_shptr->m_mutex1.set_stats(asyncshared_lock_stats_registry::global().stats(name));
+#endif // MSE_ASYNCSHARED_LOCK_STATS_ENABLED
+		}
+
 		template <class... Args>
 		static TAsyncSharedReadWriteAccessRequester make(Args&&... args) {
-			//auto shptr = std::make_shared<TAsyncSharedObj<_Ty>>(std::forward<Args>(args)...);
-			std::shared_ptr<TAsyncSharedObj<_Ty>> shptr(new TAsyncSharedObj<_Ty>(std::forward<Args>(args)...));
+			return allocate(std::allocator<_Ty>(), std::forward<Args>(args)...);
+		}
+		/* Like make(), but the shared object is allocated using (a rebound copy of) the given allocator. Either way, the
+		shared object and its reference counts are obtained in a single, cache line aligned allocation. */
+		template <class _TAllocator, class... Args>
+		static TAsyncSharedReadWriteAccessRequester allocate(const _TAllocator& allocator, Args&&... args) {
+			std::shared_ptr<TAsyncSharedObj<_Ty>> shptr = impl::asyncshared::allocate_shared_obj<_Ty>(allocator, std::forward<Args>(args)...);
 			TAsyncSharedReadWriteAccessRequester retval(shptr);
 			return retval;
 		}
@@ -526,6 +1477,7 @@ namespace mse {
 
 		std::shared_ptr<TAsyncSharedObj<_Ty>> m_shptr;
 
+		friend class asyncshared_task_access;
 		friend class TAsyncSharedReadOnlyAccessRequester<_Ty>;
 	};
 
@@ -533,6 +1485,10 @@ namespace mse {
 	TAsyncSharedReadWriteAccessRequester<X> make_asyncsharedreadwrite(Args&&... args) {
 		return TAsyncSharedReadWriteAccessRequester<X>::make(std::forward<Args>(args)...);
 	}
+	template <class X, class _TAllocator, class... Args>
+	TAsyncSharedReadWriteAccessRequester<X> allocate_asyncsharedreadwrite(const _TAllocator& allocator, Args&&... args) {
+		return TAsyncSharedReadWriteAccessRequester<X>::allocate(allocator, std::forward<Args>(args)...);
+	}
 
 
 	template<typename _Ty>
@@ -540,7 +1496,12 @@ namespace mse {
 	public:
 		TAsyncSharedReadOnlyConstPointer(const TAsyncSharedReadOnlyConstPointer& src) : m_shptr(src.m_shptr), m_unique_lock(src.m_shptr->m_mutex1) {}
 		TAsyncSharedReadOnlyConstPointer(TAsyncSharedReadOnlyConstPointer&& src) = default;
-		virtual ~TAsyncSharedReadOnlyConstPointer() {}
+		virtual ~TAsyncSharedReadOnlyConstPointer() {
+			if (m_unique_lock.owns_lock()) {
+				m_unique_lock.unlock();
+				m_shptr->note_lock_released();
+			}
+		}
 
 		operator bool() const {
 			//assert(is_valid()); //{ MSE_THROW(asyncshared_use_of_invalid_pointer_error("attempt to use invalid pointer - mse::TAsyncSharedReadOnlyConstPointer")); }
@@ -558,21 +1519,21 @@ namespace mse {
 		}
 	private:
 		TAsyncSharedReadOnlyConstPointer(std::shared_ptr<const TAsyncSharedObj<_Ty>> shptr) : m_shptr(shptr), m_unique_lock(shptr->m_mutex1) {}
-		TAsyncSharedReadOnlyConstPointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t) : m_shptr(shptr), m_unique_lock(shptr->m_mutex1, std::defer_lock) {
+		TAsyncSharedReadOnlyConstPointer(std::shared_ptr<const TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t) : m_shptr(shptr), m_unique_lock(shptr->m_mutex1, std::defer_lock) {
 			if (!m_unique_lock.try_lock()) {
-				shptr = nullptr;
+				m_shptr = nullptr;
 			}
 		}
 		template<class _Rep, class _Period>
-		TAsyncSharedReadOnlyConstPointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t, const std::chrono::duration<_Rep, _Period>& _Rel_time) : m_shptr(shptr), m_unique_lock(shptr->m_mutex1, std::defer_lock) {
+		TAsyncSharedReadOnlyConstPointer(std::shared_ptr<const TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t, const std::chrono::duration<_Rep, _Period>& _Rel_time) : m_shptr(shptr), m_unique_lock(shptr->m_mutex1, std::defer_lock) {
 			if (!m_unique_lock.try_lock_for(_Rel_time)) {
-				shptr = nullptr;
+				m_shptr = nullptr;
 			}
 		}
 		template<class _Clock, class _Duration>
-		TAsyncSharedReadOnlyConstPointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t, const std::chrono::time_point<_Clock, _Duration>& _Abs_time) : m_shptr(shptr), m_unique_lock(shptr->m_mutex1, std::defer_lock) {
+		TAsyncSharedReadOnlyConstPointer(std::shared_ptr<const TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t, const std::chrono::time_point<_Clock, _Duration>& _Abs_time) : m_shptr(shptr), m_unique_lock(shptr->m_mutex1, std::defer_lock) {
 			if (!m_unique_lock.try_lock_until(_Abs_time)) {
-				shptr = nullptr;
+				m_shptr = nullptr;
 			}
 		}
 		TAsyncSharedReadOnlyConstPointer<_Ty>& operator=(const TAsyncSharedReadOnlyConstPointer<_Ty>& _Right_cref) = delete;
@@ -624,10 +1585,27 @@ namespace mse {
 			return retval;
 		}
 
+		template<class _TExecutor, class _TFunction>
+		auto async_readlock_ptr(const _TExecutor& executor, const _TFunction& function)
+			-> std::future<decltype(function(std::declval<TAsyncSharedReadOnlyConstPointer<_Ty>>()))> {
+			auto requester = (*this);
+			auto try_lock_function = [requester]() mutable { return requester.try_readlock_ptr(); };
+			return impl::asyncshared::async_lock<TAsyncSharedReadOnlyConstPointer<_Ty>>(try_lock_function, m_shptr->m_async_waiters, executor, function);
+		}
+
+		void set_lock_stats_name(const std::string& name) {
+#ifdef MSE_ASYNCSHARED_LOCK_STATS_ENABLED
+			m_shptr->m_mutex1.set_stats(asyncshared_lock_stats_registry::global().stats(name));
+#endif // MSE_ASYNCSHARED_LOCK_STATS_ENABLED
+		}
+
 		template <class... Args>
 		static TAsyncSharedReadOnlyAccessRequester make(Args&&... args) {
-			//auto shptr = std::make_shared<const TAsyncSharedObj<_Ty>>(std::forward<Args>(args)...);
-			std::shared_ptr<const TAsyncSharedObj<_Ty>> shptr(new const TAsyncSharedObj<_Ty>(std::forward<Args>(args)...));
+			return allocate(std::allocator<_Ty>(), std::forward<Args>(args)...);
+		}
+		template <class _TAllocator, class... Args>
+		static TAsyncSharedReadOnlyAccessRequester allocate(const _TAllocator& allocator, Args&&... args) {
+			std::shared_ptr<const TAsyncSharedObj<_Ty>> shptr = impl::asyncshared::allocate_shared_obj<_Ty>(allocator, std::forward<Args>(args)...);
 			TAsyncSharedReadOnlyAccessRequester retval(shptr);
 			return retval;
 		}
@@ -639,12 +1617,18 @@ namespace mse {
 		const TAsyncSharedReadOnlyAccessRequester<_Ty>* operator&() const { return this; }
 
 		std::shared_ptr<const TAsyncSharedObj<_Ty>> m_shptr;
+
+		friend class asyncshared_task_access;
 	};
 
 	template <class X, class... Args>
 	TAsyncSharedReadOnlyAccessRequester<X> make_asyncsharedreadonly(Args&&... args) {
 		return TAsyncSharedReadOnlyAccessRequester<X>::make(std::forward<Args>(args)...);
 	}
+	template <class X, class _TAllocator, class... Args>
+	TAsyncSharedReadOnlyAccessRequester<X> allocate_asyncsharedreadonly(const _TAllocator& allocator, Args&&... args) {
+		return TAsyncSharedReadOnlyAccessRequester<X>::allocate(allocator, std::forward<Args>(args)...);
+	}
 
 
 	template<typename _Ty> class TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteConstPointer;
@@ -654,7 +1638,12 @@ namespace mse {
 	public:
 		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWritePointer(const TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWritePointer& src) : m_shptr(src.m_shptr), m_unique_lock(src.m_shptr->m_mutex1) {}
 		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWritePointer(TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWritePointer&& src) = default;
-		virtual ~TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWritePointer() {}
+		virtual ~TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWritePointer() {
+			if (m_unique_lock.owns_lock()) {
+				m_unique_lock.unlock();
+				m_shptr->note_lock_released();
+			}
+		}
 
 		operator bool() const {
 			//assert(is_valid()); //{ MSE_THROW(asyncshared_use_of_invalid_pointer_error("attempt to use invalid pointer - mse::TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWritePointer")); }
@@ -674,19 +1663,19 @@ namespace mse {
 		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWritePointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr) : m_shptr(shptr), m_unique_lock(shptr->m_mutex1) {}
 		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWritePointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t) : m_shptr(shptr), m_unique_lock(shptr->m_mutex1, std::defer_lock) {
 			if (!m_unique_lock.try_lock()) {
-				shptr = nullptr;
+				m_shptr = nullptr;
 			}
 		}
 		template<class _Rep, class _Period>
 		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWritePointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t, const std::chrono::duration<_Rep, _Period>& _Rel_time) : m_shptr(shptr), m_unique_lock(shptr->m_mutex1, std::defer_lock) {
 			if (!m_unique_lock.try_lock_for(_Rel_time)) {
-				shptr = nullptr;
+				m_shptr = nullptr;
 			}
 		}
 		template<class _Clock, class _Duration>
 		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWritePointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t, const std::chrono::time_point<_Clock, _Duration>& _Abs_time) : m_shptr(shptr), m_unique_lock(shptr->m_mutex1, std::defer_lock) {
 			if (!m_unique_lock.try_lock_until(_Abs_time)) {
-				shptr = nullptr;
+				m_shptr = nullptr;
 			}
 		}
 		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWritePointer<_Ty>& operator=(const TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWritePointer<_Ty>& _Right_cref) = delete;
@@ -712,7 +1701,12 @@ namespace mse {
 		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteConstPointer(const TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteConstPointer& src) : m_shptr(src.m_shptr), m_shared_lock(src.m_shptr->m_mutex1) {}
 		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteConstPointer(TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteConstPointer&& src) = default;
 		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteConstPointer(const TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWritePointer<_Ty>& src) : m_shptr(src.m_shptr), m_shared_lock(src.m_shptr->m_mutex1) {}
-		virtual ~TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteConstPointer() {}
+		virtual ~TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteConstPointer() {
+			if (m_shared_lock.owns_lock()) {
+				m_shared_lock.unlock();
+				m_shptr->note_lock_released();
+			}
+		}
 
 		operator bool() const {
 			//assert(is_valid()); //{ MSE_THROW(asyncshared_use_of_invalid_pointer_error("attempt to use invalid pointer - mse::TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteConstPointer")); }
@@ -732,19 +1726,19 @@ namespace mse {
 		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteConstPointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr) : m_shptr(shptr), m_shared_lock(shptr->m_mutex1) {}
 		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteConstPointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t) : m_shptr(shptr), m_shared_lock(shptr->m_mutex1, std::defer_lock) {
 			if (!m_shared_lock.try_lock()) {
-				shptr = nullptr;
+				m_shptr = nullptr;
 			}
 		}
 		template<class _Rep, class _Period>
 		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteConstPointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t, const std::chrono::duration<_Rep, _Period>& _Rel_time) : m_shptr(shptr), m_shared_lock(shptr->m_mutex1, std::defer_lock) {
 			if (!m_shared_lock.try_lock_for(_Rel_time)) {
-				shptr = nullptr;
+				m_shptr = nullptr;
 			}
 		}
 		template<class _Clock, class _Duration>
 		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteConstPointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t, const std::chrono::time_point<_Clock, _Duration>& _Abs_time) : m_shptr(shptr), m_shared_lock(shptr->m_mutex1, std::defer_lock) {
 			if (!m_shared_lock.try_lock_until(_Abs_time)) {
-				shptr = nullptr;
+				m_shptr = nullptr;
 			}
 		}
 		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteConstPointer<_Ty>& operator=(const TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteConstPointer<_Ty>& _Right_cref) = delete;
@@ -821,10 +1815,38 @@ namespace mse {
 			return retval;
 		}
 
+		template<class _TExecutor, class _TFunction>
+		auto async_writelock_ptr(const _TExecutor& executor, const _TFunction& function)
+			-> std::future<decltype(function(std::declval<TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWritePointer<_Ty>>()))> {
+			auto requester = (*this);
+			auto try_lock_function = [requester]() mutable { return requester.try_writelock_ptr(); };
+			return impl::asyncshared::async_lock<TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWritePointer<_Ty>>(try_lock_function, m_shptr->m_async_waiters, executor, function);
+		}
+		template<class _TExecutor, class _TFunction>
+		auto async_readlock_ptr(const _TExecutor& executor, const _TFunction& function)
+			-> std::future<decltype(function(std::declval<TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteConstPointer<_Ty>>()))> {
+			auto requester = (*this);
+			auto try_lock_function = [requester]() mutable { return requester.try_readlock_ptr(); };
+			return impl::asyncshared::async_lock<TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteConstPointer<_Ty>>(try_lock_function, m_shptr->m_async_waiters, executor, function);
+		}
+
+		template<class _TFunction>
+		void apply_async(const _TFunction& function) {
+			m_shptr->post_update(function);
+		}
+		void set_lock_stats_name(const std::string& name) {
+#ifdef MSE_ASYNCSHARED_LOCK_STATS_ENABLED
+			m_shptr->m_mutex1.set_stats(asyncshared_lock_stats_registry::global().stats(name));
+#endif // MSE_ASYNCSHARED_LOCK_STATS_ENABLED
+		}
+
 		template <class... Args>
 		static TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteAccessRequester make(Args&&... args) {
-			//auto shptr = std::make_shared<TAsyncSharedObj<_Ty>>(std::forward<Args>(args)...);
-			std::shared_ptr<TAsyncSharedObj<_Ty>> shptr(new TAsyncSharedObj<_Ty>(std::forward<Args>(args)...));
+			return allocate(std::allocator<_Ty>(), std::forward<Args>(args)...);
+		}
+		template <class _TAllocator, class... Args>
+		static TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteAccessRequester allocate(const _TAllocator& allocator, Args&&... args) {
+			std::shared_ptr<TAsyncSharedObj<_Ty>> shptr = impl::asyncshared::allocate_shared_obj<_Ty>(allocator, std::forward<Args>(args)...);
 			TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteAccessRequester retval(shptr);
 			return retval;
 		}
@@ -836,12 +1858,18 @@ namespace mse {
 		const TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteAccessRequester<_Ty>* operator&() const { return this; }
 
 		std::shared_ptr<TAsyncSharedObj<_Ty>> m_shptr;
+
+		friend class asyncshared_task_access;
 	};
 
 	template <class X, class... Args>
 	TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteAccessRequester<X> make_asyncsharedobjectthatyouaresurehasnounprotectedmutablesreadwrite(Args&&... args) {
 		return TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteAccessRequester<X>::make(std::forward<Args>(args)...);
 	}
+	template <class X, class _TAllocator, class... Args>
+	TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteAccessRequester<X> allocate_asyncsharedobjectthatyouaresurehasnounprotectedmutablesreadwrite(const _TAllocator& allocator, Args&&... args) {
+		return TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteAccessRequester<X>::allocate(allocator, std::forward<Args>(args)...);
+	}
 
 
 	template<typename _Ty>
@@ -849,7 +1877,12 @@ namespace mse {
 	public:
 		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer(const TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer& src) : m_shptr(src.m_shptr), m_shared_lock(src.m_shptr->m_mutex1) {}
 		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer(TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer&& src) = default;
-		virtual ~TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer() {}
+		virtual ~TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer() {
+			if (m_shared_lock.owns_lock()) {
+				m_shared_lock.unlock();
+				m_shptr->note_lock_released();
+			}
+		}
 
 		operator bool() const {
 			//assert(is_valid()); //{ MSE_THROW(asyncshared_use_of_invalid_pointer_error("attempt to use invalid pointer - mse::TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer")); }
@@ -867,21 +1900,21 @@ namespace mse {
 		}
 	private:
 		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer(std::shared_ptr<const TAsyncSharedObj<_Ty>> shptr) : m_shptr(shptr), m_shared_lock(shptr->m_mutex1) {}
-		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t) : m_shptr(shptr), m_shared_lock(shptr->m_mutex1, std::defer_lock) {
+		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer(std::shared_ptr<const TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t) : m_shptr(shptr), m_shared_lock(shptr->m_mutex1, std::defer_lock) {
 			if (!m_shared_lock.try_lock()) {
-				shptr = nullptr;
+				m_shptr = nullptr;
 			}
 		}
 		template<class _Rep, class _Period>
-		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t, const std::chrono::duration<_Rep, _Period>& _Rel_time) : m_shptr(shptr), m_shared_lock(shptr->m_mutex1, std::defer_lock) {
+		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer(std::shared_ptr<const TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t, const std::chrono::duration<_Rep, _Period>& _Rel_time) : m_shptr(shptr), m_shared_lock(shptr->m_mutex1, std::defer_lock) {
 			if (!m_shared_lock.try_lock_for(_Rel_time)) {
-				shptr = nullptr;
+				m_shptr = nullptr;
 			}
 		}
 		template<class _Clock, class _Duration>
-		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer(std::shared_ptr<TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t, const std::chrono::time_point<_Clock, _Duration>& _Abs_time) : m_shptr(shptr), m_shared_lock(shptr->m_mutex1, std::defer_lock) {
+		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer(std::shared_ptr<const TAsyncSharedObj<_Ty>> shptr, std::try_to_lock_t, const std::chrono::time_point<_Clock, _Duration>& _Abs_time) : m_shptr(shptr), m_shared_lock(shptr->m_mutex1, std::defer_lock) {
 			if (!m_shared_lock.try_lock_until(_Abs_time)) {
-				shptr = nullptr;
+				m_shptr = nullptr;
 			}
 		}
 		TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer<_Ty>& operator=(const TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer<_Ty>& _Right_cref) = delete;
@@ -933,10 +1966,27 @@ namespace mse {
 			return retval;
 		}
 
+		template<class _TExecutor, class _TFunction>
+		auto async_readlock_ptr(const _TExecutor& executor, const _TFunction& function)
+			-> std::future<decltype(function(std::declval<TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer<_Ty>>()))> {
+			auto requester = (*this);
+			auto try_lock_function = [requester]() mutable { return requester.try_readlock_ptr(); };
+			return impl::asyncshared::async_lock<TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyConstPointer<_Ty>>(try_lock_function, m_shptr->m_async_waiters, executor, function);
+		}
+
+		void set_lock_stats_name(const std::string& name) {
+#ifdef MSE_ASYNCSHARED_LOCK_STATS_ENABLED
+			m_shptr->m_mutex1.set_stats(asyncshared_lock_stats_registry::global().stats(name));
+#endif // MSE_ASYNCSHARED_LOCK_STATS_ENABLED
+		}
+
 		template <class... Args>
 		static TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyAccessRequester make(Args&&... args) {
-			//auto shptr = std::make_shared<const TAsyncSharedObj<_Ty>>(std::forward<Args>(args)...);
-			std::shared_ptr<const TAsyncSharedObj<_Ty>> shptr(new const TAsyncSharedObj<_Ty>(std::forward<Args>(args)...));
+			return allocate(std::allocator<_Ty>(), std::forward<Args>(args)...);
+		}
+		template <class _TAllocator, class... Args>
+		static TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyAccessRequester allocate(const _TAllocator& allocator, Args&&... args) {
+			std::shared_ptr<const TAsyncSharedObj<_Ty>> shptr = impl::asyncshared::allocate_shared_obj<_Ty>(allocator, std::forward<Args>(args)...);
 			TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyAccessRequester retval(shptr);
 			return retval;
 		}
@@ -948,18 +1998,1201 @@ namespace mse {
 		const TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyAccessRequester<_Ty>* operator&() const { return this; }
 
 		std::shared_ptr<const TAsyncSharedObj<_Ty>> m_shptr;
+
+		friend class asyncshared_task_access;
 	};
 
 	template <class X, class... Args>
 	TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyAccessRequester<X> make_asyncsharedobjectthatyouaresurehasnounprotectedmutablesreadonly(Args&&... args) {
 		return TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyAccessRequester<X>::make(std::forward<Args>(args)...);
 	}
+	template <class X, class _TAllocator, class... Args>
+	TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyAccessRequester<X> allocate_asyncsharedobjectthatyouaresurehasnounprotectedmutablesreadonly(const _TAllocator& allocator, Args&&... args) {
+		return TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyAccessRequester<X>::allocate(allocator, std::forward<Args>(args)...);
+	}
+
+
+	namespace impl {
+		namespace asyncshared {
+			struct writelock_policy {
+				template<class _TAccessRequester>
+				static auto lock(_TAccessRequester& requester) -> decltype(requester.writelock_ptr()) { return requester.writelock_ptr(); }
+				template<class _TAccessRequester>
+				static auto try_lock(_TAccessRequester& requester) -> decltype(requester.try_writelock_ptr()) { return requester.try_writelock_ptr(); }
+			};
+			struct readlock_policy {
+				template<class _TAccessRequester>
+				static auto lock(_TAccessRequester& requester) -> decltype(requester.readlock_ptr()) { return requester.readlock_ptr(); }
+				template<class _TAccessRequester>
+				static auto try_lock(_TAccessRequester& requester) -> decltype(requester.try_readlock_ptr()) { return requester.try_readlock_ptr(); }
+			};
+
+			/* Helper functions that apply an operation to the element of a tuple specified by a (run-time) index. */
+			template<size_t I, size_t N>
+			struct lock_all_helper {
+				template<class _TLockPolicy, class _TRequesterTuple, class _TMaybePointerTuple>
+				static void lock_one(size_t index, _TRequesterTuple& requesters, _TMaybePointerTuple& maybe_pointers) {
+					if (I == index) {
+						std::get<I>(maybe_pointers).emplace(_TLockPolicy::lock(std::get<I>(requesters)));
+					}
+					else {
+						lock_all_helper<I + 1, N>::template lock_one<_TLockPolicy>(index, requesters, maybe_pointers);
+					}
+				}
+				/* Attempts to lock each element except the one specified. Returns the index of the first one that fails, or
+				N if they all succeed. */
+				template<class _TLockPolicy, class _TRequesterTuple, class _TMaybePointerTuple>
+				static size_t try_lock_the_rest(size_t already_locked_index, _TRequesterTuple& requesters, _TMaybePointerTuple& maybe_pointers) {
+					if (I != already_locked_index) {
+						auto maybe_pointer = _TLockPolicy::try_lock(std::get<I>(requesters));
+						if (!maybe_pointer) {
+							return I;
+						}
+						std::get<I>(maybe_pointers).emplace(std::move(*maybe_pointer));
+					}
+					return lock_all_helper<I + 1, N>::template try_lock_the_rest<_TLockPolicy>(already_locked_index, requesters, maybe_pointers);
+				}
+			};
+			template<size_t N>
+			struct lock_all_helper<N, N> {
+				template<class _TLockPolicy, class _TRequesterTuple, class _TMaybePointerTuple>
+				static void lock_one(size_t index, _TRequesterTuple& requesters, _TMaybePointerTuple& maybe_pointers) {
+					assert(false);
+				}
+				template<class _TLockPolicy, class _TRequesterTuple, class _TMaybePointerTuple>
+				static size_t try_lock_the_rest(size_t already_locked_index, _TRequesterTuple& requesters, _TMaybePointerTuple& maybe_pointers) {
+					return N;
+				}
+			};
+
+			template<class _TMaybePointerTuple, size_t... Is>
+			auto release_pointers_from_optionals(_TMaybePointerTuple& maybe_pointers, std::index_sequence<Is...>)
+				-> std::tuple<typename std::decay<decltype(*std::get<Is>(maybe_pointers))>::type...> {
+				return std::tuple<typename std::decay<decltype(*std::get<Is>(maybe_pointers))>::type...>(std::move(*std::get<Is>(maybe_pointers))...);
+			}
+
+			/* Like std::lock(), this blocks on (only) one lock at a time, and "try"s the rest. If any "try" fails, all the
+			obtained locks are released and the process starts again, this time blocking on the lock that failed. So no
+			thread ever blocks while holding any of the locks, precluding deadlock between callers, regardless of the order
+			in which they specify the objects. */
+			template<class _TLockPolicy, class... _TAccessRequesters>
+			auto lock_all(_TAccessRequesters... requesters)
+				-> std::tuple<decltype(_TLockPolicy::lock(std::declval<_TAccessRequesters&>()))...> {
+				static const size_t N = sizeof...(_TAccessRequesters);
+				static_assert(1 <= N, "at least one access requester is required - mse::lock_all()");
+				auto requester_tuple = std::make_tuple(requesters...);
+				size_t index_to_block_on = 0;
+				while (true) {
+					std::tuple<mse::optional<decltype(_TLockPolicy::lock(std::declval<_TAccessRequesters&>()))>...> maybe_pointers;
+					lock_all_helper<0, N>::template lock_one<_TLockPolicy>(index_to_block_on, requester_tuple, maybe_pointers);
+					const auto failed_index = lock_all_helper<0, N>::template try_lock_the_rest<_TLockPolicy>(index_to_block_on, requester_tuple, maybe_pointers);
+					if (N == failed_index) {
+						return release_pointers_from_optionals(maybe_pointers, std::make_index_sequence<N>());
+					}
+					/* The obtained locks are released (when maybe_pointers goes out of scope) before trying again. */
+					index_to_block_on = failed_index;
+					std::this_thread::yield();
+				}
+			}
+		}
+	}
+
+	/* lock_all() obtains write locks on all the objects targeted by the given access requesters, returning an
+	std::tuple of the (lock holding) pointers, in the same order as the access requesters. It uses a deadlock avoidance
+	algorithm (like std::lock()'s) so that threads simultaneously locking overlapping sets of objects (in any order)
+	won't deadlock. readlock_all() is the same, but obtains read locks. */
+	template<class... _TAccessRequesters>
+	auto lock_all(const _TAccessRequesters&... requesters)
+		-> std::tuple<decltype(std::declval<_TAccessRequesters&>().writelock_ptr())...> {
+		return impl::asyncshared::lock_all<impl::asyncshared::writelock_policy>(requesters...);
+	}
+	template<class... _TAccessRequesters>
+	auto readlock_all(const _TAccessRequesters&... requesters)
+		-> std::tuple<decltype(std::declval<_TAccessRequesters&>().readlock_ptr())...> {
+		return impl::asyncshared::lock_all<impl::asyncshared::readlock_policy>(requesters...);
+	}
+
+
+	/* TAsyncSharedShardedMap partitions its keys among a number of independently locked "shards". Each shard is an
+	std::unordered_map shared via its own TAsyncSharedReadWriteAccessRequester, so threads working with keys that
+	reside in different shards don't contend for the same lock. The writelock_ptr() and readlock_ptr() member
+	functions take a key and return the same kind of (lock holding) pointers that the access requesters do, but
+	targeting the shard that contains (or would contain) the given key. Like the access requesters,
+	TAsyncSharedShardedMap can be copied and passed by value (to another thread, generally). Copies share the same
+	shards. */
+	template<typename _TKey, typename _TMapped, class _THash = std::hash<_TKey>, class _TKeyEqual = std::equal_to<_TKey>>
+	class TAsyncSharedShardedMap {
+	public:
+		typedef std::unordered_map<_TKey, _TMapped, _THash, _TKeyEqual> map_type;
+		/* (Shared objects are allocated cache line aligned, so the shards don't share cache lines with each other.) */
+		class shard_type : public map_type {
+		public:
+			typedef map_type base_class;
+			shard_type() {}
+			using base_class::operator=;
+		};
+		typedef TAsyncSharedReadWriteAccessRequester<shard_type> shard_access_requester_type;
+		typedef TAsyncSharedReadWritePointer<shard_type> shard_writelock_ptr_type;
+		typedef TAsyncSharedReadWriteConstPointer<shard_type> shard_readlock_ptr_type;
+		typedef typename map_type::key_type key_type;
+		typedef typename map_type::mapped_type mapped_type;
+		typedef typename map_type::size_type size_type;
+
+		TAsyncSharedShardedMap(const TAsyncSharedShardedMap& src_cref) = default;
+
+		shard_writelock_ptr_type writelock_ptr(const key_type& key) {
+			return m_shard_access_requesters[shard_index(key)].writelock_ptr();
+		}
+		mse::optional<shard_writelock_ptr_type> try_writelock_ptr(const key_type& key) {
+			return m_shard_access_requesters[shard_index(key)].try_writelock_ptr();
+		}
+		template<class _Rep, class _Period>
+		mse::optional<shard_writelock_ptr_type> try_writelock_ptr_for(const key_type& key, const std::chrono::duration<_Rep, _Period>& _Rel_time) {
+			return m_shard_access_requesters[shard_index(key)].try_writelock_ptr_for(_Rel_time);
+		}
+		template<class _Clock, class _Duration>
+		mse::optional<shard_writelock_ptr_type> try_writelock_ptr_until(const key_type& key, const std::chrono::time_point<_Clock, _Duration>& _Abs_time) {
+			return m_shard_access_requesters[shard_index(key)].try_writelock_ptr_until(_Abs_time);
+		}
+		shard_readlock_ptr_type readlock_ptr(const key_type& key) {
+			return m_shard_access_requesters[shard_index(key)].readlock_ptr();
+		}
+		mse::optional<shard_readlock_ptr_type> try_readlock_ptr(const key_type& key) {
+			return m_shard_access_requesters[shard_index(key)].try_readlock_ptr();
+		}
+		template<class _Rep, class _Period>
+		mse::optional<shard_readlock_ptr_type> try_readlock_ptr_for(const key_type& key, const std::chrono::duration<_Rep, _Period>& _Rel_time) {
+			return m_shard_access_requesters[shard_index(key)].try_readlock_ptr_for(_Rel_time);
+		}
+		template<class _Clock, class _Duration>
+		mse::optional<shard_readlock_ptr_type> try_readlock_ptr_until(const key_type& key, const std::chrono::time_point<_Clock, _Duration>& _Abs_time) {
+			return m_shard_access_requesters[shard_index(key)].try_readlock_ptr_until(_Abs_time);
+		}
+
+		size_type shard_count() const { return m_shard_access_requesters.size(); }
+		size_type shard_index(const key_type& key) const {
+			/* The hash value is "mixed" before being reduced so that keys in the same shard don't all share the same low
+			order bits (which the shard's own hash table would otherwise rely on to distribute them among its buckets). */
+			std::uint64_t h = static_cast<std::uint64_t>(m_hasher(key));
+			h ^= (h >> 33);
+			h *= 0xff51afd7ed558ccdULL;
+			h ^= (h >> 33);
+			return size_type(h % m_shard_access_requesters.size());
+		}
+		/* For operations (like iterating over all the elements) that need to be done on a shard by shard basis. */
+		shard_access_requester_type shard_access_requester(size_type index) const {
+			return m_shard_access_requesters.at(index);
+		}
+		/* Note that the shards are locked one at a time, so the result is not necessarily a "snapshot" of any single
+		moment if other threads are concurrently modifying the map. */
+		size_type size() {
+			size_type retval = 0;
+			for (auto& shard_access_requester : m_shard_access_requesters) {
+				retval += shard_access_requester.readlock_ptr()->size();
+			}
+			return retval;
+		}
+		/* Records the lock contention statistics of all the shards under the given name (when
+		MSE_ASYNCSHARED_LOCK_STATS_ENABLED is defined). */
+		void set_lock_stats_name(const std::string& name) {
+			for (auto& shard_access_requester : m_shard_access_requesters) {
+				shard_access_requester.set_lock_stats_name(name);
+			}
+		}
+
+		static size_type default_shard_count() {
+			auto num_hardware_threads = size_type(std::thread::hardware_concurrency());
+			if (1 > num_hardware_threads) { num_hardware_threads = 1; }
+			/* More shards than hardware threads reduces the likelihood of any two threads colliding on the same shard. */
+			return 4/*arbitrary*/ * num_hardware_threads;
+		}
+		static TAsyncSharedShardedMap make(size_type num_shards = default_shard_count()) {
+			if (1 > num_shards) { MSE_THROW(asyncshared_runtime_error("invalid number of shards - TAsyncSharedShardedMap make() - mse::TAsyncSharedShardedMap")); }
+			TAsyncSharedShardedMap retval(num_shards);
+			return retval;
+		}
+
+	private:
+		TAsyncSharedShardedMap(size_type num_shards) {
+			m_shard_access_requesters.reserve(num_shards);
+			for (size_type i = 0; i < num_shards; i += 1) {
+				m_shard_access_requesters.push_back(shard_access_requester_type::make());
+			}
+		}
+
+		TAsyncSharedShardedMap* operator&() { return this; }
+		const TAsyncSharedShardedMap* operator&() const { return this; }
+
+		std::vector<shard_access_requester_type> m_shard_access_requesters;
+		_THash m_hasher;
+	};
+
+	template <class _TKey, class _TMapped, class _THash = std::hash<_TKey>, class _TKeyEqual = std::equal_to<_TKey>>
+	TAsyncSharedShardedMap<_TKey, _TMapped, _THash, _TKeyEqual> make_asyncsharedshardedmap(typename TAsyncSharedShardedMap<_TKey, _TMapped, _THash, _TKeyEqual>::size_type num_shards
+		= TAsyncSharedShardedMap<_TKey, _TMapped, _THash, _TKeyEqual>::default_shard_count()) {
+		return TAsyncSharedShardedMap<_TKey, _TMapped, _THash, _TKeyEqual>::make(num_shards);
+	}
+
+
+	namespace impl {
+		namespace asyncshared {
+			/* TBoundedMPMCQueueState is a bounded, lock-free, multi-producer/multi-consumer ring buffer (based on Dmitry
+			Vyukov's well known algorithm). Each slot has a sequence number that indicates whether it is ready to be
+			written to or read from on a given "lap" of the ring, so producers and consumers only contend with each other
+			(via compare-and-swap) on the enqueue and dequeue positions. Elements are moved into and out of the slots; no
+			references to the slots are ever handed out. */
+			template<typename _Ty>
+			class TBoundedMPMCQueueState {
+			public:
+				typedef size_t size_type;
+
+				TBoundedMPMCQueueState(size_type capacity) : m_cells(round_up_to_power_of_two(capacity)), m_index_mask(m_cells.size() - 1) {
+					for (size_type i = 0; m_cells.size() > i; i += 1) {
+						m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+					}
+				}
+				~TBoundedMPMCQueueState() {
+					while (try_pop()) {}
+				}
+
+				template<class _TValue>
+				bool try_push(_TValue&& value) {
+					cell_type* cell_ptr = nullptr;
+					auto pos = m_enqueue_pos.load(std::memory_order_relaxed);
+					while (true) {
+						cell_ptr = std::addressof(m_cells[pos & m_index_mask]);
+						const auto sequence = cell_ptr->m_sequence.load(std::memory_order_acquire);
+						const auto diff = std::intptr_t(sequence) - std::intptr_t(pos);
+						if (0 == diff) {
+							if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+								break;
+							}
+						}
+						else if (0 > diff) {
+							/* The queue is full. */
+							return false;
+						}
+						else {
+							pos = m_enqueue_pos.load(std::memory_order_relaxed);
+						}
+					}
+					try {
+						::new (static_cast<void*>(std::addressof(cell_ptr->m_storage))) _Ty(std::forward<_TValue>(value));
+						cell_ptr->m_has_value = true;
+					}
+					catch (...) {
+						/* The slot has already been claimed, so we release it (as a slot that contains no value, to be
+						skipped by consumers) before passing the exception on. */
+						cell_ptr->m_has_value = false;
+						cell_ptr->m_sequence.store(pos + 1, std::memory_order_release);
+						notify_consumers();
+						throw;
+					}
+					cell_ptr->m_sequence.store(pos + 1, std::memory_order_release);
+					notify_consumers();
+					return true;
+				}
+				mse::optional<_Ty> try_pop() {
+					while (true) {
+						cell_type* cell_ptr = nullptr;
+						auto pos = m_dequeue_pos.load(std::memory_order_relaxed);
+						while (true) {
+							cell_ptr = std::addressof(m_cells[pos & m_index_mask]);
+							const auto sequence = cell_ptr->m_sequence.load(std::memory_order_acquire);
+							const auto diff = std::intptr_t(sequence) - std::intptr_t(pos + 1);
+							if (0 == diff) {
+								if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+									break;
+								}
+							}
+							else if (0 > diff) {
+								/* The queue is empty. */
+								return{};
+							}
+							else {
+								pos = m_dequeue_pos.load(std::memory_order_relaxed);
+							}
+						}
+						if (!(cell_ptr->m_has_value)) {
+							/* The producer of this slot failed to construct its element. */
+							cell_ptr->m_sequence.store(pos + m_index_mask + 1, std::memory_order_release);
+							notify_producers();
+							continue;
+						}
+						_Ty* element_ptr = reinterpret_cast<_Ty*>(std::addressof(cell_ptr->m_storage));
+						struct CSlotReleaser {
+							~CSlotReleaser() {
+								m_element_ptr->~_Ty();
+								m_cell_ptr->m_sequence.store(m_pos + m_state_ref.m_index_mask + 1, std::memory_order_release);
+								m_state_ref.notify_producers();
+							}
+							TBoundedMPMCQueueState& m_state_ref;
+							cell_type* m_cell_ptr;
+							_Ty* m_element_ptr;
+							size_type m_pos;
+						} slot_releaser{ *this, cell_ptr, element_ptr, pos };
+						return mse::optional<_Ty>(std::move(*element_ptr));
+					}
+				}
+
+				template<class _TValue>
+				void push(_TValue&& value) {
+					wait_until(m_num_waiting_producers, [this, &value]() { return try_push(std::forward<_TValue>(value)); }, std::chrono::steady_clock::time_point::max());
+				}
+				template<class _TValue, class _Clock, class _Duration>
+				bool try_push_until(_TValue&& value, const std::chrono::time_point<_Clock, _Duration>& _Abs_time) {
+					return wait_until(m_num_waiting_producers, [this, &value]() { return try_push(std::forward<_TValue>(value)); }, _Abs_time);
+				}
+				_Ty pop() {
+					mse::optional<_Ty> retval;
+					wait_until(m_num_waiting_consumers, [this, &retval]() {
+						auto maybe_value = try_pop();
+						if (!maybe_value) { return false; }
+						retval.emplace(std::move(*maybe_value));
+						return true;
+					}, std::chrono::steady_clock::time_point::max());
+					return std::move(*retval);
+				}
+				template<class _Clock, class _Duration>
+				mse::optional<_Ty> try_pop_until(const std::chrono::time_point<_Clock, _Duration>& _Abs_time) {
+					mse::optional<_Ty> retval;
+					wait_until(m_num_waiting_consumers, [this, &retval]() {
+						auto maybe_value = try_pop();
+						if (!maybe_value) { return false; }
+						retval.emplace(std::move(*maybe_value));
+						return true;
+					}, _Abs_time);
+					return retval;
+				}
+
+				size_type capacity() const { return m_cells.size(); }
+				/* The result is only a "snapshot" of some recent moment if other threads are concurrently using the queue. */
+				size_type approximate_size() const {
+					const auto dequeue_pos = m_dequeue_pos.load(std::memory_order_relaxed);
+					const auto enqueue_pos = m_enqueue_pos.load(std::memory_order_relaxed);
+					return (enqueue_pos > dequeue_pos) ? ((enqueue_pos - dequeue_pos < capacity()) ? (enqueue_pos - dequeue_pos) : capacity()) : 0;
+				}
+
+			private:
+				struct cell_type {
+					std::atomic<size_type> m_sequence{ 0 };
+					bool m_has_value = false;
+					typename std::aligned_storage<sizeof(_Ty), alignof(_Ty)>::type m_storage;
+				};
+
+				static size_type round_up_to_power_of_two(size_type value) {
+					size_type retval = 1;
+					while (value > retval) {
+						retval <<= 1;
+					}
+					return retval;
+				}
+
+				/* The blocking operations only block (on a condition variable) after a (non-blocking) attempt fails. The
+				counts of waiting threads allow the non-blocking operations to skip notification when no thread is waiting
+				(the common case). The "notification generation" ensures that a notification that occurs between a failed
+				attempt and the subsequent wait isn't missed. */
+				template<class _TTryFunction, class _Clock, class _Duration>
+				bool wait_until(std::atomic<int>& num_waiting_ref, const _TTryFunction& try_function, const std::chrono::time_point<_Clock, _Duration>& _Abs_time) {
+					if (try_function()) {
+						return true;
+					}
+					num_waiting_ref.fetch_add(1);
+					bool retval = false;
+					while (true) {
+						const auto notification_generation = m_notification_generation.load();
+						if (try_function()) {
+							retval = true;
+							break;
+						}
+						std::unique_lock<std::mutex> lock1(m_wait_mutex);
+						auto predicate = [this, notification_generation]() { return notification_generation != m_notification_generation.load(); };
+						if (std::chrono::time_point<_Clock, _Duration>::max() == _Abs_time) {
+							m_wait_cv.wait(lock1, predicate);
+						}
+						else if (!m_wait_cv.wait_until(lock1, _Abs_time, predicate)) {
+							break;
+						}
+					}
+					num_waiting_ref.fetch_sub(1);
+					return retval;
+				}
+				void notify_waiters(std::atomic<int>& num_waiting_ref) {
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+					if (0 != num_waiting_ref.load()) {
+						std::lock_guard<std::mutex> lock1(m_wait_mutex);
+						m_notification_generation.fetch_add(1);
+						m_wait_cv.notify_all();
+					}
+				}
+				void notify_consumers() { notify_waiters(m_num_waiting_consumers); }
+				void notify_producers() { notify_waiters(m_num_waiting_producers); }
+
+				std::vector<cell_type> m_cells;
+				const size_type m_index_mask;
+				/* The enqueue and dequeue positions are each on their own cache line. */
+				alignas(MSE_ASYNCSHARED_CACHE_LINE_SIZE) std::atomic<size_type> m_enqueue_pos{ 0 };
+				alignas(MSE_ASYNCSHARED_CACHE_LINE_SIZE) std::atomic<size_type> m_dequeue_pos{ 0 };
+				alignas(MSE_ASYNCSHARED_CACHE_LINE_SIZE) std::atomic<int> m_num_waiting_producers{ 0 };
+				std::atomic<int> m_num_waiting_consumers{ 0 };
+				std::atomic<size_type> m_notification_generation{ 0 };
+				std::mutex m_wait_mutex;
+				std::condition_variable m_wait_cv;
+			};
+		}
+	}
+
+	/* TAsyncSharedQueue is a bounded, lock-free, multi-producer/multi-consumer queue for passing (ownership of) elements
+	between asynchronous threads. Elements are moved (or copied) into and out of the queue, so no references to the
+	queue's contents are ever exposed. The non-blocking try_push() and try_pop() fail (rather than block) when the queue
+	is full or empty (respectively). The blocking push() and pop() wait (without spinning) until they can succeed. And
+	the limited-blocking try_push_for(), try_pop_for(), try_push_until() and try_pop_until() are also available. Use
+	mse::make_asyncsharedqueue<>() to obtain a TAsyncSharedQueue. The capacity is rounded up to a power of two. Like
+	the access requesters, TAsyncSharedQueue can be copied and passed by value (to another thread, generally). Copies
+	share the same queue. */
+	template<typename _Ty>
+	class TAsyncSharedQueue {
+	public:
+		typedef _Ty value_type;
+		typedef typename impl::asyncshared::TBoundedMPMCQueueState<_Ty>::size_type size_type;
+
+		TAsyncSharedQueue(const TAsyncSharedQueue& src_cref) = default;
+
+		bool try_push(const _Ty& value) { return m_shptr->try_push(value); }
+		bool try_push(_Ty&& value) { return m_shptr->try_push(std::move(value)); }
+		void push(const _Ty& value) { m_shptr->push(value); }
+		void push(_Ty&& value) { m_shptr->push(std::move(value)); }
+		template<class _Rep, class _Period>
+		bool try_push_for(_Ty value, const std::chrono::duration<_Rep, _Period>& _Rel_time) {
+			return m_shptr->try_push_until(std::move(value), std::chrono::steady_clock::now() + _Rel_time);
+		}
+		template<class _Clock, class _Duration>
+		bool try_push_until(_Ty value, const std::chrono::time_point<_Clock, _Duration>& _Abs_time) {
+			return m_shptr->try_push_until(std::move(value), _Abs_time);
+		}
+
+		mse::optional<_Ty> try_pop() { return m_shptr->try_pop(); }
+		_Ty pop() { return m_shptr->pop(); }
+		template<class _Rep, class _Period>
+		mse::optional<_Ty> try_pop_for(const std::chrono::duration<_Rep, _Period>& _Rel_time) {
+			return m_shptr->try_pop_until(std::chrono::steady_clock::now() + _Rel_time);
+		}
+		template<class _Clock, class _Duration>
+		mse::optional<_Ty> try_pop_until(const std::chrono::time_point<_Clock, _Duration>& _Abs_time) {
+			return m_shptr->try_pop_until(_Abs_time);
+		}
+
+		size_type capacity() const { return m_shptr->capacity(); }
+		size_type approximate_size() const { return m_shptr->approximate_size(); }
+
+		static TAsyncSharedQueue make(size_type capacity) {
+			if (1 > capacity) { MSE_THROW(asyncshared_runtime_error("invalid capacity - TAsyncSharedQueue make() - mse::TAsyncSharedQueue")); }
+			typedef impl::asyncshared::TBoundedMPMCQueueState<_Ty> state_type;
+			TAsyncSharedQueue retval(std::allocate_shared<state_type>(TAsyncSharedCacheLineAlignedAllocator<state_type>(), capacity));
+			return retval;
+		}
+
+	private:
+		TAsyncSharedQueue(std::shared_ptr<impl::asyncshared::TBoundedMPMCQueueState<_Ty>> shptr) : m_shptr(shptr) {}
+
+		TAsyncSharedQueue* operator&() { return this; }
+		const TAsyncSharedQueue* operator&() const { return this; }
+
+		std::shared_ptr<impl::asyncshared::TBoundedMPMCQueueState<_Ty>> m_shptr;
+	};
+
+	template <class _Ty>
+	TAsyncSharedQueue<_Ty> make_asyncsharedqueue(typename TAsyncSharedQueue<_Ty>::size_type capacity) {
+		return TAsyncSharedQueue<_Ty>::make(capacity);
+	}
+
+	/* asyncshared_task_access is used to declare which shared objects (specified by their access requesters) a task
+	submitted to an asyncshared_task_scheduler will access, and whether it will modify them. Note that the
+	(non-"Sure") TAsyncSharedReadWriteAccessRequester and TAsyncSharedReadOnlyAccessRequester obtain exclusive locks
+	even for read access, so read access via those requesters is treated as exclusive. */
+	class asyncshared_task_access {
+	public:
+		template<typename _Ty>
+		asyncshared_task_access& reads(const TAsyncSharedReadWriteAccessRequester<_Ty>& access_requester) {
+			return add(access_requester.m_shptr.get(), true);
+		}
+		template<typename _Ty>
+		asyncshared_task_access& reads(const TAsyncSharedReadOnlyAccessRequester<_Ty>& access_requester) {
+			return add(access_requester.m_shptr.get(), true);
+		}
+		template<typename _Ty>
+		asyncshared_task_access& reads(const TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteAccessRequester<_Ty>& access_requester) {
+			return add(access_requester.m_shptr.get(), false);
+		}
+		template<typename _Ty>
+		asyncshared_task_access& reads(const TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyAccessRequester<_Ty>& access_requester) {
+			return add(access_requester.m_shptr.get(), false);
+		}
+		template<typename _Ty>
+		asyncshared_task_access& writes(const TAsyncSharedReadWriteAccessRequester<_Ty>& access_requester) {
+			return add(access_requester.m_shptr.get(), true);
+		}
+		template<typename _Ty>
+		asyncshared_task_access& writes(const TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadWriteAccessRequester<_Ty>& access_requester) {
+			return add(access_requester.m_shptr.get(), true);
+		}
+
+	private:
+		asyncshared_task_access& add(const void* shared_object_id, bool is_exclusive) {
+			for (auto& access_ref : m_accesses) {
+				if (shared_object_id == access_ref.first) {
+					access_ref.second = access_ref.second || is_exclusive;
+					return (*this);
+				}
+			}
+			m_accesses.emplace_back(shared_object_id, is_exclusive);
+			return (*this);
+		}
+
+		std::vector<std::pair<const void*, bool>> m_accesses;
+
+		friend class asyncshared_task_scheduler;
+	};
+
+	/* asyncshared_task_scheduler is a work-stealing thread pool that is aware of the shared objects its tasks access.
+	Tasks are submitted along with an asyncshared_task_access declaring the shared objects they read and write. Tasks
+	whose declared accesses don't conflict are run concurrently, while a task that conflicts with a running task is
+	held back (in submission order) until the conflict clears, rather than occupying a thread blocked on a lock. Tasks
+	submitted from within a task are pushed onto the (local) deque of the worker thread running it, from which other
+	workers steal when they run out of work. The locks are still obtained (via the access requesters) as usual, so an
+	incorrect declaration costs concurrency, not safety. Tasks should not block waiting for the completion of other
+	tasks submitted to the same scheduler. The destructor waits for all submitted tasks to complete. */
+	class asyncshared_task_scheduler {
+	public:
+		typedef size_t size_type;
+
+		explicit asyncshared_task_scheduler(size_type num_threads = default_num_threads()) {
+			if (1 > num_threads) { num_threads = 1; }
+			for (size_type i = 0; i < num_threads; i += 1) {
+				m_workers.emplace_back(new worker_type);
+			}
+			m_threads.reserve(num_threads);
+			for (size_type i = 0; i < num_threads; i += 1) {
+				m_threads.emplace_back([this, i]() { (*this).worker_loop(i); });
+			}
+		}
+		~asyncshared_task_scheduler() {
+			wait_until_idle();
+			{
+				std::lock_guard<std::mutex> lock(m_sleep_mutex);
+				m_stopping = true;
+			}
+			m_sleep_cv.notify_all();
+			for (auto& thread_ref : m_threads) {
+				thread_ref.join();
+			}
+		}
+
+		template<class _TFunction>
+		auto submit(const asyncshared_task_access& access, _TFunction&& function) -> std::future<decltype(function())> {
+			typedef decltype(function()) result_t;
+			auto packaged_task_shptr = std::make_shared<std::packaged_task<result_t()>>(std::forward<_TFunction>(function));
+			auto retval = packaged_task_shptr->get_future();
+			task_uptr_t task_uptr(new task_type{ [packaged_task_shptr]() { (*packaged_task_shptr)(); }, access.m_accesses });
+			m_num_outstanding_tasks.fetch_add(1);
+			if (task_uptr->m_accesses.empty()) {
+				enqueue_runnable(std::move(task_uptr));
+			}
+			else {
+				std::vector<task_uptr_t> runnable_tasks;
+				{
+					std::lock_guard<std::mutex> lock(m_access_mutex);
+					m_waiting_tasks.push_back(std::move(task_uptr));
+					runnable_tasks = take_runnable_waiting_tasks();
+				}
+				for (auto& runnable_task_uptr : runnable_tasks) {
+					enqueue_runnable(std::move(runnable_task_uptr));
+				}
+			}
+			return retval;
+		}
+		template<class _TFunction>
+		auto submit(_TFunction&& function) -> std::future<decltype(function())> {
+			return submit(asyncshared_task_access(), std::forward<_TFunction>(function));
+		}
+
+		/* Blocks until all submitted tasks (including tasks submitted by tasks) have completed. */
+		void wait_until_idle() {
+			std::unique_lock<std::mutex> lock(m_idle_mutex);
+			m_idle_cv.wait(lock, [this]() { return 0 == m_num_outstanding_tasks.load(); });
+		}
+
+		size_type num_threads() const { return m_threads.size(); }
+
+		static size_type default_num_threads() {
+			const size_type hardware_concurrency = std::thread::hardware_concurrency();
+			return (1 <= hardware_concurrency) ? hardware_concurrency : 1;
+		}
+
+	private:
+		asyncshared_task_scheduler(const asyncshared_task_scheduler&) = delete;
+		asyncshared_task_scheduler& operator=(const asyncshared_task_scheduler&) = delete;
+
+		struct task_type {
+			std::function<void()> m_function;
+			std::vector<std::pair<const void*, bool>> m_accesses;
+		};
+		typedef std::unique_ptr<task_type> task_uptr_t;
+
+		/* Each worker's deque is accessed at the back by its owner and at the front by thieves. */
+		struct worker_type {
+			std::mutex m_mutex;
+			std::deque<task_uptr_t> m_deque;
+		};
+		struct access_state_type {
+			size_t m_num_shared_accessors = 0;
+			bool m_has_exclusive_accessor = false;
+		};
+		struct current_worker_type {
+			const asyncshared_task_scheduler* m_scheduler_ptr = nullptr;
+			size_type m_index = 0;
+		};
+		static current_worker_type& this_thread_current_worker_ref() {
+			thread_local current_worker_type tl_current_worker;
+			return tl_current_worker;
+		}
+
+		/* Moves the waiting tasks whose accesses don't conflict with those of the running tasks, or with those of
+		earlier waiting tasks, out of the wait list and marks their accesses as in use. m_access_mutex must be held. */
+		std::vector<task_uptr_t> take_runnable_waiting_tasks() {
+			std::vector<task_uptr_t> retval;
+			/* maps each shared object accessed by a (still) waiting task to whether any of those accesses are exclusive */
+			std::unordered_map<const void*, bool> held_back_accesses;
+			for (auto it = m_waiting_tasks.begin(); m_waiting_tasks.end() != it;) {
+				bool is_runnable = true;
+				for (const auto& access : (*it)->m_accesses) {
+					const auto found_it = m_access_states.find(access.first);
+					const auto held_back_it = held_back_accesses.find(access.first);
+					if (access.second) {
+						if ((m_access_states.end() != found_it) || (held_back_accesses.end() != held_back_it)) {
+							is_runnable = false;
+						}
+					}
+					else {
+						if (((m_access_states.end() != found_it) && found_it->second.m_has_exclusive_accessor)
+							|| ((held_back_accesses.end() != held_back_it) && held_back_it->second)) {
+							is_runnable = false;
+						}
+					}
+				}
+				if (is_runnable) {
+					for (const auto& access : (*it)->m_accesses) {
+						auto& access_state_ref = m_access_states[access.first];
+						if (access.second) {
+							access_state_ref.m_has_exclusive_accessor = true;
+						}
+						else {
+							access_state_ref.m_num_shared_accessors += 1;
+						}
+					}
+					retval.push_back(std::move(*it));
+					it = m_waiting_tasks.erase(it);
+				}
+				else {
+					for (const auto& access : (*it)->m_accesses) {
+						auto& is_exclusive_ref = held_back_accesses[access.first];
+						is_exclusive_ref = is_exclusive_ref || access.second;
+					}
+					it++;
+				}
+			}
+			return retval;
+		}
+		void release_accesses(const task_type& task) {
+			std::vector<task_uptr_t> runnable_tasks;
+			{
+				std::lock_guard<std::mutex> lock(m_access_mutex);
+				for (const auto& access : task.m_accesses) {
+					auto found_it = m_access_states.find(access.first);
+					assert(m_access_states.end() != found_it);
+					if (access.second) {
+						found_it->second.m_has_exclusive_accessor = false;
+					}
+					else {
+						found_it->second.m_num_shared_accessors -= 1;
+					}
+					if ((!found_it->second.m_has_exclusive_accessor) && (0 == found_it->second.m_num_shared_accessors)) {
+						m_access_states.erase(found_it);
+					}
+				}
+				runnable_tasks = take_runnable_waiting_tasks();
+			}
+			for (auto& runnable_task_uptr : runnable_tasks) {
+				enqueue_runnable(std::move(runnable_task_uptr));
+			}
+		}
+
+		void enqueue_runnable(task_uptr_t task_uptr) {
+			/* The count is incremented first so that it never understates the number of queued tasks. */
+			m_num_queued_tasks.fetch_add(1);
+			const auto& current_worker_cref = this_thread_current_worker_ref();
+			if (this == current_worker_cref.m_scheduler_ptr) {
+				auto& worker_ref = *(m_workers[current_worker_cref.m_index]);
+				std::lock_guard<std::mutex> lock(worker_ref.m_mutex);
+				worker_ref.m_deque.push_back(std::move(task_uptr));
+			}
+			else {
+				std::lock_guard<std::mutex> lock(m_injection_mutex);
+				m_injection_queue.push_back(std::move(task_uptr));
+			}
+			{
+				std::lock_guard<std::mutex> lock(m_sleep_mutex);
+			}
+			m_sleep_cv.notify_one();
+		}
+		task_uptr_t take_task(size_type worker_index) {
+			task_uptr_t retval;
+			{
+				auto& worker_ref = *(m_workers[worker_index]);
+				std::lock_guard<std::mutex> lock(worker_ref.m_mutex);
+				if (!worker_ref.m_deque.empty()) {
+					retval = std::move(worker_ref.m_deque.back());
+					worker_ref.m_deque.pop_back();
+				}
+			}
+			if (!retval) {
+				std::lock_guard<std::mutex> lock(m_injection_mutex);
+				if (!m_injection_queue.empty()) {
+					retval = std::move(m_injection_queue.front());
+					m_injection_queue.pop_front();
+				}
+			}
+			for (size_type i = 1; (!retval) && (i < m_workers.size()); i += 1) {
+				auto& victim_ref = *(m_workers[(worker_index + i) % m_workers.size()]);
+				std::lock_guard<std::mutex> lock(victim_ref.m_mutex);
+				if (!victim_ref.m_deque.empty()) {
+					retval = std::move(victim_ref.m_deque.front());
+					victim_ref.m_deque.pop_front();
+				}
+			}
+			if (retval) {
+				m_num_queued_tasks.fetch_sub(1);
+			}
+			return retval;
+		}
+		void worker_loop(size_type worker_index) {
+			auto& current_worker_ref = this_thread_current_worker_ref();
+			current_worker_ref.m_scheduler_ptr = this;
+			current_worker_ref.m_index = worker_index;
+			while (true) {
+				auto task_uptr = take_task(worker_index);
+				if (task_uptr) {
+					/* The function is a wrapped std::packaged_task, so it doesn't throw. */
+					task_uptr->m_function();
+					if (!(task_uptr->m_accesses.empty())) {
+						release_accesses(*task_uptr);
+					}
+					task_uptr = nullptr;
+					if (1 == m_num_outstanding_tasks.fetch_sub(1)) {
+						std::lock_guard<std::mutex> lock(m_idle_mutex);
+						m_idle_cv.notify_all();
+					}
+					continue;
+				}
+				std::unique_lock<std::mutex> lock(m_sleep_mutex);
+				m_sleep_cv.wait(lock, [this]() { return m_stopping || (0 < m_num_queued_tasks.load()); });
+				if (m_stopping && (0 == m_num_queued_tasks.load())) {
+					break;
+				}
+			}
+			current_worker_ref = current_worker_type();
+		}
+
+		std::vector<std::unique_ptr<worker_type>> m_workers;
+		std::mutex m_injection_mutex;
+		std::deque<task_uptr_t> m_injection_queue;
+		std::atomic<size_type> m_num_queued_tasks{ 0 };
+
+		std::mutex m_access_mutex;
+		std::unordered_map<const void*, access_state_type> m_access_states;
+		std::list<task_uptr_t> m_waiting_tasks;
+
+		std::atomic<size_type> m_num_outstanding_tasks{ 0 };
+		std::mutex m_idle_mutex;
+		std::condition_variable m_idle_cv;
+
+		std::mutex m_sleep_mutex;
+		std::condition_variable m_sleep_cv;
+		bool m_stopping = false;
+
+		std::vector<std::thread> m_threads;
+	};
+
+	namespace impl {
+		namespace asyncshared {
+			/* A one-shot "event" used by a thread blocked on one or more channels. */
+			class channel_wakeup {
+			public:
+				void notify() {
+					{
+						std::lock_guard<std::mutex> lock1(m_mutex);
+						m_is_notified = true;
+					}
+					m_cv.notify_all();
+				}
+				void wait() {
+					std::unique_lock<std::mutex> lock1(m_mutex);
+					m_cv.wait(lock1, [this]() { return m_is_notified; });
+				}
+			private:
+				std::mutex m_mutex;
+				std::condition_variable m_cv;
+				bool m_is_notified = false;
+			};
+			/* The threads blocked waiting on a channel. The count allows notify_all() to skip the mutex when no thread is
+			waiting (the common case). A waiter registers itself and then re-checks the channel, so a notification that
+			occurs between the (failed) check and the registration can't be missed. */
+			class channel_wakeup_list {
+			public:
+				void add(channel_wakeup& wakeup_ref) {
+					std::lock_guard<std::mutex> lock1(m_mutex);
+					m_wakeup_ptrs.push_back(std::addressof(wakeup_ref));
+					m_num_wakeups.fetch_add(1);
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+				}
+				void remove(channel_wakeup& wakeup_ref) {
+					std::lock_guard<std::mutex> lock1(m_mutex);
+					auto found_it = std::find(m_wakeup_ptrs.begin(), m_wakeup_ptrs.end(), std::addressof(wakeup_ref));
+					if (m_wakeup_ptrs.end() != found_it) {
+						m_wakeup_ptrs.erase(found_it);
+						m_num_wakeups.fetch_sub(1);
+					}
+				}
+				void notify_all() {
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+					if (0 == m_num_wakeups.load()) {
+						return;
+					}
+					std::lock_guard<std::mutex> lock1(m_mutex);
+					for (auto wakeup_ptr : m_wakeup_ptrs) {
+						wakeup_ptr->notify();
+					}
+				}
+			private:
+				std::atomic<int> m_num_wakeups{ 0 };
+				std::mutex m_mutex;
+				std::vector<channel_wakeup*> m_wakeup_ptrs;
+			};
+			class channel_wakeup_registration {
+			public:
+				channel_wakeup_registration(channel_wakeup_list& wakeup_list_ref, channel_wakeup& wakeup_ref)
+					: m_wakeup_list_ref(wakeup_list_ref), m_wakeup_ref(wakeup_ref) {
+					m_wakeup_list_ref.add(m_wakeup_ref);
+				}
+				~channel_wakeup_registration() {
+					m_wakeup_list_ref.remove(m_wakeup_ref);
+				}
+			private:
+				channel_wakeup_list& m_wakeup_list_ref;
+				channel_wakeup& m_wakeup_ref;
+			};
+
+			template<typename _Ty>
+			class TChannelState {
+			public:
+				typedef typename TBoundedMPMCQueueState<_Ty>::size_type size_type;
+
+				TChannelState(size_type capacity) : m_queue(capacity) {}
+
+				/* Moves as many of the given elements as there is room for into the channel, and returns the number moved. */
+				template<class _TIterator>
+				size_type try_send_many(_TIterator first, _TIterator last) {
+					m_num_active_senders.fetch_add(1);
+					if (m_is_closed.load()) {
+						m_num_active_senders.fetch_sub(1);
+						MSE_THROW(asyncshared_runtime_error("send on closed channel - size_type try_send_many(_TIterator first, _TIterator last) - mse::TChannel"));
+					}
+					size_type num_sent = 0;
+					try {
+						/* An element is only moved from if there is room for it. */
+						for (; (last != first) && m_queue.try_push(std::move(*first)); ++first) {
+							num_sent += 1;
+						}
+					}
+					catch (...) {
+						m_num_active_senders.fetch_sub(1);
+						m_recv_wakeups.notify_all();
+						throw;
+					}
+					m_num_active_senders.fetch_sub(1);
+					if (1 <= num_sent) {
+						/* Just one notification per batch. */
+						m_recv_wakeups.notify_all();
+					}
+					return num_sent;
+				}
+				template<class _TIterator>
+				void send_many(_TIterator first, _TIterator last) {
+					while (true) {
+						std::advance(first, try_send_many(first, last));
+						if (last == first) { break; }
+						channel_wakeup wakeup;
+						channel_wakeup_registration registration(m_send_wakeups, wakeup);
+						std::advance(first, try_send_many(first, last));
+						if (last == first) { break; }
+						wakeup.wait();
+					}
+				}
+
+				mse::optional<_Ty> try_recv() {
+					auto retval = m_queue.try_pop();
+					if (retval) {
+						m_send_wakeups.notify_all();
+					}
+					return retval;
+				}
+				/* Blocks until an element is available (or the channel is closed and drained). */
+				mse::optional<_Ty> recv() {
+					while (true) {
+						auto retval = try_recv();
+						if (retval || is_closed_and_drained()) { return retval; }
+						channel_wakeup wakeup;
+						channel_wakeup_registration registration(m_recv_wakeups, wakeup);
+						retval = try_recv();
+						if (retval || is_closed_and_drained()) { return retval; }
+						wakeup.wait();
+					}
+				}
+				/* Moves up to max_count elements out of the channel and appends them to the given vector. */
+				size_type try_recv_many(std::vector<_Ty>& dest_ref, size_type max_count) {
+					size_type num_received = 0;
+					for (; max_count > num_received; num_received += 1) {
+						auto maybe_value = m_queue.try_pop();
+						if (!maybe_value) { break; }
+						dest_ref.push_back(std::move(*maybe_value));
+					}
+					if (1 <= num_received) {
+						m_send_wakeups.notify_all();
+					}
+					return num_received;
+				}
+				/* Blocks until at least one element is available (or the channel is closed and drained). */
+				size_type recv_many(std::vector<_Ty>& dest_ref, size_type max_count) {
+					if (1 > max_count) { return 0; }
+					while (true) {
+						auto num_received = try_recv_many(dest_ref, max_count);
+						if ((1 <= num_received) || is_closed_and_drained()) { return num_received; }
+						channel_wakeup wakeup;
+						channel_wakeup_registration registration(m_recv_wakeups, wakeup);
+						num_received = try_recv_many(dest_ref, max_count);
+						if ((1 <= num_received) || is_closed_and_drained()) { return num_received; }
+						wakeup.wait();
+					}
+				}
+
+				void close() {
+					m_is_closed.store(true);
+					m_recv_wakeups.notify_all();
+					m_send_wakeups.notify_all();
+				}
+				bool is_closed() const { return m_is_closed.load(); }
+				/* True once the channel has been closed and all the elements sent to it have been received. */
+				bool is_closed_and_drained() const {
+					/* The order of these checks matters. */
+					return m_is_closed.load() && (0 == m_num_active_senders.load()) && (0 == m_queue.approximate_size());
+				}
+
+				size_type capacity() const { return m_queue.capacity(); }
+				size_type approximate_size() const { return m_queue.approximate_size(); }
+
+				channel_wakeup_list& recv_wakeups_ref() { return m_recv_wakeups; }
+
+			private:
+				TBoundedMPMCQueueState<_Ty> m_queue;
+				std::atomic<bool> m_is_closed{ false };
+				std::atomic<int> m_num_active_senders{ 0 };
+				channel_wakeup_list m_recv_wakeups;
+				channel_wakeup_list m_send_wakeups;
+			};
+		}
+	}
+
+	/* TChannel is a bounded channel for transferring ownership of (typically large, move-only) messages between threads.
+	Unlike TAsyncSharedQueue, TChannel only accepts elements by rvalue reference, so the sender is left with only a
+	moved-from object, and no access to the message it sent. No per message allocation, reference counting or locking
+	is required. send_many() and recv_many() transfer batches of elements with a single notification of waiting
+	threads. A channel can be close()d, after which sending to it throws an exception, and receiving from it yields
+	any remaining elements followed by an empty mse::optional<> (from recv()) or an empty batch (from recv_many()). You
+	can also wait on multiple channels at once with mse::select_recv(). Use mse::make_channel<>() to obtain a TChannel.
+	Copies of a TChannel share the same channel. */
+	template<typename _Ty>
+	class TChannel {
+	public:
+		typedef _Ty value_type;
+		typedef typename impl::asyncshared::TChannelState<_Ty>::size_type size_type;
+
+		TChannel(const TChannel& src_cref) = default;
+
+		bool try_send(_Ty&& value) {
+			return (1 == m_shptr->try_send_many(std::addressof(value), std::addressof(value) + 1));
+		}
+		void send(_Ty&& value) {
+			m_shptr->send_many(std::addressof(value), std::addressof(value) + 1);
+		}
+		void try_send(const _Ty& value) = delete;
+		void send(const _Ty& value) = delete;
+		/* The elements in the given range are moved from. */
+		template<class _TIterator>
+		size_type try_send_many(_TIterator first, _TIterator last) {
+			return m_shptr->try_send_many(first, last);
+		}
+		template<class _TIterator>
+		void send_many(_TIterator first, _TIterator last) {
+			m_shptr->send_many(first, last);
+		}
+		void send_many(std::vector<_Ty>&& values) {
+			m_shptr->send_many(values.begin(), values.end());
+			values.clear();
+		}
+
+		mse::optional<_Ty> try_recv() { return m_shptr->try_recv(); }
+		/* Returns an empty mse::optional<> only if the channel is closed and drained. */
+		mse::optional<_Ty> recv() { return m_shptr->recv(); }
+		std::vector<_Ty> try_recv_many(size_type max_count) {
+			std::vector<_Ty> retval;
+			m_shptr->try_recv_many(retval, max_count);
+			return retval;
+		}
+		std::vector<_Ty> recv_many(size_type max_count) {
+			std::vector<_Ty> retval;
+			m_shptr->recv_many(retval, max_count);
+			return retval;
+		}
+
+		void close() { m_shptr->close(); }
+		bool is_closed() const { return m_shptr->is_closed(); }
+		size_type capacity() const { return m_shptr->capacity(); }
+		size_type approximate_size() const { return m_shptr->approximate_size(); }
+
+		static TChannel make(size_type capacity) {
+			if (1 > capacity) { MSE_THROW(asyncshared_runtime_error("invalid capacity - TChannel make() - mse::TChannel")); }
+			typedef impl::asyncshared::TChannelState<_Ty> state_type;
+			TChannel retval(std::allocate_shared<state_type>(TAsyncSharedCacheLineAlignedAllocator<state_type>(), capacity));
+			return retval;
+		}
+
+	private:
+		TChannel(std::shared_ptr<impl::asyncshared::TChannelState<_Ty>> shptr) : m_shptr(shptr) {}
+
+		TChannel* operator&() { return this; }
+		const TChannel* operator&() const { return this; }
+
+		std::shared_ptr<impl::asyncshared::TChannelState<_Ty>> m_shptr;
+
+		template<typename _Ty2, class _THandler> friend class TChannelRecvCase;
+	};
+
+	template <class _Ty>
+	TChannel<_Ty> make_channel(typename TChannel<_Ty>::size_type capacity) {
+		return TChannel<_Ty>::make(capacity);
+	}
+
+	namespace impl {
+		namespace asyncshared {
+			class channel_recv_case_base {
+			public:
+				virtual ~channel_recv_case_base() {}
+				virtual bool try_recv_and_handle() = 0;
+				virtual bool is_closed_and_drained() const = 0;
+				virtual channel_wakeup_list& recv_wakeups_ref() = 0;
+			};
+		}
+	}
+
+	/* A channel paired with the function to be called with an element received from it by mse::select_recv(). Use
+	mse::make_channel_recv_case() to obtain one. */
+	template<typename _Ty, class _THandler>
+	class TChannelRecvCase : public impl::asyncshared::channel_recv_case_base {
+	public:
+		TChannelRecvCase(const TChannel<_Ty>& channel, const _THandler& handler) : m_shptr(channel.m_shptr), m_handler(handler) {}
+
+		bool try_recv_and_handle() override {
+			auto maybe_value = m_shptr->try_recv();
+			if (!maybe_value) {
+				return false;
+			}
+			m_handler(std::move(*maybe_value));
+			return true;
+		}
+		bool is_closed_and_drained() const override { return m_shptr->is_closed_and_drained(); }
+		impl::asyncshared::channel_wakeup_list& recv_wakeups_ref() override { return m_shptr->recv_wakeups_ref(); }
+
+	private:
+		std::shared_ptr<impl::asyncshared::TChannelState<_Ty>> m_shptr;
+		_THandler m_handler;
+	};
+
+	template<typename _Ty, class _THandler>
+	TChannelRecvCase<_Ty, _THandler> make_channel_recv_case(const TChannel<_Ty>& channel, const _THandler& handler) {
+		return TChannelRecvCase<_Ty, _THandler>(channel, handler);
+	}
+
+	namespace impl {
+		namespace asyncshared {
+			template<size_t N>
+			mse::optional<size_t> try_select_recv(std::array<channel_recv_case_base*, N>& case_ptrs, bool& all_closed_and_drained_ref) {
+				/* The channels are tried in a (per thread) rotating order so that no channel is starved. */
+				thread_local size_t tl_rotation = 0;
+				tl_rotation += 1;
+				for (size_t i = 0; N > i; i += 1) {
+					const auto index = (tl_rotation + i) % N;
+					if (case_ptrs[index]->try_recv_and_handle()) {
+						return index;
+					}
+				}
+				all_closed_and_drained_ref = true;
+				for (auto case_ptr : case_ptrs) {
+					all_closed_and_drained_ref = all_closed_and_drained_ref && case_ptr->is_closed_and_drained();
+				}
+				return{};
+			}
+		}
+	}
+
+	/* select_recv() blocks until an element can be received from one of the given channels, receives it and passes it to
+	that channel's handler. It returns the (zero-based) index of the case that was handled, or an empty mse::optional<>
+	if all the channels are closed and drained. try_select_recv() is the same, but returns an empty mse::optional<>
+	rather than block if no element is available. */
+	template<class... _TRecvCases>
+	mse::optional<size_t> try_select_recv(_TRecvCases... recv_cases) {
+		std::array<impl::asyncshared::channel_recv_case_base*, sizeof...(_TRecvCases)> case_ptrs = { { std::addressof(recv_cases)... } };
+		bool all_closed_and_drained = false;
+		return impl::asyncshared::try_select_recv(case_ptrs, all_closed_and_drained);
+	}
+	template<class... _TRecvCases>
+	mse::optional<size_t> select_recv(_TRecvCases... recv_cases) {
+		static const size_t N = sizeof...(_TRecvCases);
+		static_assert(1 <= N, "at least one channel is required - mse::select_recv()");
+		std::array<impl::asyncshared::channel_recv_case_base*, N> case_ptrs = { { std::addressof(recv_cases)... } };
+		while (true) {
+			bool all_closed_and_drained = false;
+			auto retval = impl::asyncshared::try_select_recv(case_ptrs, all_closed_and_drained);
+			if (retval || all_closed_and_drained) { return retval; }
+
+			impl::asyncshared::channel_wakeup wakeup;
+			std::vector<std::unique_ptr<impl::asyncshared::channel_wakeup_registration>> registrations;
+			registrations.reserve(N);
+			for (auto case_ptr : case_ptrs) {
+				registrations.emplace_back(new impl::asyncshared::channel_wakeup_registration(case_ptr->recv_wakeups_ref(), wakeup));
+			}
+			retval = impl::asyncshared::try_select_recv(case_ptrs, all_closed_and_drained);
+			if (retval || all_closed_and_drained) { return retval; }
+			wakeup.wait();
+		}
+	}
 
 
 	/* For "read-only" situations when you need, or want, the shared object to be managed by std::shared_ptrs we provide a
 	slightly safety enhanced std::shared_ptr wrapper. The wrapper enforces "const"ness and tries to ensure that it always
 	points to a validly allocated object. Use mse::make_stdsharedimmutable<>() to construct an
 	mse::TStdSharedImmutableFixedPointer. And again, beware of sharing objects with mutable members. */
+	template<typename _Ty> class TStdSharedImmutableSnapshotPublisher;
+
 	template<typename _Ty>
 	class TStdSharedImmutableFixedPointer : public std::shared_ptr<const _Ty> {
 	public:
@@ -980,6 +3213,8 @@ namespace mse {
 
 		//TStdSharedImmutableFixedPointer<_Ty>* operator&() { return this; }
 		//const TStdSharedImmutableFixedPointer<_Ty>* operator&() const { return this; }
+
+		friend class TStdSharedImmutableSnapshotPublisher<_Ty>;
 	};
 
 	template <class X, class... Args>
@@ -987,6 +3222,116 @@ namespace mse {
 		return TStdSharedImmutableFixedPointer<X>::make(std::forward<Args>(args)...);
 	}
 
+	/* TStdSharedImmutableSnapshotPublisher holds the "current version" of an immutable object, and allows a new version
+	to be (atomically) published at any time. snapshot() returns a TStdSharedImmutableFixedPointer to the current
+	version, which remains valid (and unchanged) regardless of any subsequently published versions. This is suitable
+	for things like (hot-reloadable) configuration settings.
+	Obtaining a snapshot is cheap in the common case where the version hasn't changed since the calling thread's
+	previous snapshot: Each thread caches its most recently obtained version, so the common case consists of reading the
+	(rarely modified) version number, and incrementing a reference count that is local to the thread. Like the access
+	requesters, TStdSharedImmutableSnapshotPublisher can be copied and passed by value (to another thread, generally).
+	Copies share the same current version. */
+	template<typename _Ty>
+	class TStdSharedImmutableSnapshotPublisher {
+	public:
+		typedef TStdSharedImmutableFixedPointer<_Ty> snapshot_type;
+		typedef std::uint64_t version_type;
+
+		TStdSharedImmutableSnapshotPublisher(const TStdSharedImmutableSnapshotPublisher& src_cref) = default;
+
+		snapshot_type snapshot() const {
+			const auto version = m_state_shptr->m_version.load(std::memory_order_acquire);
+			auto& cache_entry_ref = this_thread_cache_entry_ref();
+			if (version != cache_entry_ref.m_version) {
+				std::shared_ptr<const _Ty> global_shptr;
+				{
+					std::lock_guard<std::mutex> lock1(m_state_shptr->m_mutex);
+					global_shptr = m_state_shptr->m_current_shptr;
+					cache_entry_ref.m_version = m_state_shptr->m_version.load(std::memory_order_relaxed);
+				}
+				/* The thread's cached pointer shares ownership of the version via its own reference count (which only
+				this thread modifies when obtaining snapshots). */
+				auto thread_holder_shptr = std::make_shared<std::shared_ptr<const _Ty>>(std::move(global_shptr));
+				cache_entry_ref.m_thread_local_shptr = std::shared_ptr<const _Ty>(thread_holder_shptr, thread_holder_shptr->get());
+			}
+			return snapshot_type(cache_entry_ref.m_thread_local_shptr);
+		}
+		void publish(const snapshot_type& new_version) {
+			std::shared_ptr<const _Ty> previous_shptr;
+			{
+				std::lock_guard<std::mutex> lock1(m_state_shptr->m_mutex);
+				previous_shptr = std::move(m_state_shptr->m_current_shptr);
+				m_state_shptr->m_current_shptr = new_version;
+				m_state_shptr->m_version.fetch_add(1, std::memory_order_release);
+			}
+			/* (The previous version, if no longer referenced, is destroyed outside of the lock.) */
+		}
+		template <class... Args>
+		void emplace_and_publish(Args&&... args) {
+			publish(snapshot_type::make(std::forward<Args>(args)...));
+		}
+		/* The number of versions published so far (including the initial one). */
+		version_type version() const {
+			return m_state_shptr->m_version.load(std::memory_order_acquire);
+		}
+
+		static TStdSharedImmutableSnapshotPublisher make(const snapshot_type& initial_version) {
+			TStdSharedImmutableSnapshotPublisher retval(initial_version);
+			return retval;
+		}
+
+	private:
+		struct state_type {
+			state_type(const std::shared_ptr<const _Ty>& initial_shptr) : m_current_shptr(initial_shptr), m_id(new_id()) {}
+			static version_type new_id() {
+				static std::atomic<version_type> s_next_id{ 1 };
+				return s_next_id.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			/* The version number is on its own cache line, as it is read by every snapshot() call. */
+			alignas(MSE_ASYNCSHARED_CACHE_LINE_SIZE) std::atomic<version_type> m_version{ 1 };
+			alignas(MSE_ASYNCSHARED_CACHE_LINE_SIZE) std::mutex m_mutex;
+			std::shared_ptr<const _Ty> m_current_shptr;
+			const version_type m_id;
+		};
+		struct cache_entry_type {
+			version_type m_publisher_id = 0;
+			std::weak_ptr<state_type> m_publisher_state_wptr;
+			version_type m_version = 0;
+			std::shared_ptr<const _Ty> m_thread_local_shptr;
+		};
+
+		TStdSharedImmutableSnapshotPublisher(const snapshot_type& initial_version)
+			: m_state_shptr(std::allocate_shared<state_type>(TAsyncSharedCacheLineAlignedAllocator<state_type>(), initial_version)) {}
+
+		/* Each thread has a (small) cache of the versions it most recently obtained from each publisher (of this type).
+		Entries of publishers that no longer exist are discarded (releasing their versions) when a new entry is added. */
+		cache_entry_type& this_thread_cache_entry_ref() const {
+			thread_local std::vector<cache_entry_type> tl_cache_entries;
+			for (auto& cache_entry : tl_cache_entries) {
+				if (m_state_shptr->m_id == cache_entry.m_publisher_id) {
+					return cache_entry;
+				}
+			}
+			tl_cache_entries.erase(std::remove_if(tl_cache_entries.begin(), tl_cache_entries.end()
+				, [](const cache_entry_type& cache_entry) { return cache_entry.m_publisher_state_wptr.expired(); }), tl_cache_entries.end());
+			tl_cache_entries.emplace_back();
+			tl_cache_entries.back().m_publisher_id = m_state_shptr->m_id;
+			tl_cache_entries.back().m_publisher_state_wptr = m_state_shptr;
+			return tl_cache_entries.back();
+		}
+
+		TStdSharedImmutableSnapshotPublisher* operator&() { return this; }
+		const TStdSharedImmutableSnapshotPublisher* operator&() const { return this; }
+
+		std::shared_ptr<state_type> m_state_shptr;
+	};
+
+	template <class X, class... Args>
+	TStdSharedImmutableSnapshotPublisher<X> make_stdsharedimmutablesnapshotpublisher(Args&&... args) {
+		return TStdSharedImmutableSnapshotPublisher<X>::make(TStdSharedImmutableFixedPointer<X>::make(std::forward<Args>(args)...));
+	}
+
 	/* Legacy aliases. */
 	template<typename _Ty> using TReadOnlyStdSharedFixedConstPointer = TStdSharedImmutableFixedPointer<_Ty>;
 	template <class X, class... Args>
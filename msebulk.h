@@ -0,0 +1,445 @@
+// Copyright (c) 2015 Noah Lopez
+// Use, modification, and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#ifndef MSEBULK_H_
+#define MSEBULK_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#ifndef MSE_BULK_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (2 <= _M_IX86_FP))
+#define MSE_BULK_SSE2
+#include <emmintrin.h>
+#endif // defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (2 <= _M_IX86_FP))
+#if defined(MSE_BULK_SSE2) && defined(__AVX__)
+#define MSE_BULK_AVX
+#include <immintrin.h>
+#endif // defined(MSE_BULK_SSE2) && defined(__AVX__)
+#endif // !MSE_BULK_NO_SIMD
+
+#ifdef MSE_CUSTOM_THROW_DEFINITION
+#include <iostream>
+#define MSE_THROW(x) MSE_CUSTOM_THROW_DEFINITION(x)
+#else // MSE_CUSTOM_THROW_DEFINITION
+#define MSE_THROW(x) throw(x)
+#endif // MSE_CUSTOM_THROW_DEFINITION
+
+namespace mse {
+
+	class bulk_range_error : public std::range_error { public:
+		using std::range_error::range_error;
+	};
+
+	namespace bulk {
+		namespace impl {
+			/* (The container type may be deduced as a reference type, as the destination containers are taken by
+			"forwarding" reference so that temporary spans can be passed.) */
+			template<class _TContainer>
+			using element_t = typename std::remove_reference<decltype(*(std::declval<_TContainer&>().data()))>::type;
+			template<class _TContainer>
+			using value_t = typename std::remove_cv<element_t<_TContainer>>::type;
+
+			/* A native pointer to the elements of a (contiguous) container, and the number of elements. The container's
+			size is queried once, so element access through the range doesn't need to be checked again. Ranges are only
+			used for the duration of a bulk operation call, during which the container is not resized. */
+			template<class _TElement>
+			class TCheckedRange {
+			public:
+				template<class _TContainer>
+				explicit TCheckedRange(_TContainer& container) : m_size(container.size()) {
+					m_begin = (0 < m_size) ? container.data() : nullptr;
+				}
+				_TElement* begin() const { return m_begin; }
+				size_t size() const { return m_size; }
+
+			private:
+				_TElement* m_begin = nullptr;
+				size_t m_size = 0;
+			};
+			template<class _TContainer>
+			TCheckedRange<element_t<_TContainer>> make_checked_range(_TContainer& container) {
+				return TCheckedRange<element_t<_TContainer>>(container);
+			}
+
+			/* simd_traits<> provides the vector operations used by the kernels for the element types that have them. Element
+			types without a specialization just use the scalar kernels. */
+			template<class _Ty>
+			struct simd_traits {
+				static const bool sc_enabled = false;
+			};
+
+#ifdef MSE_BULK_AVX
+			template<>
+			struct simd_traits<float> {
+				static const bool sc_enabled = true;
+				typedef __m256 vector_type;
+				static const size_t sc_width = 8;
+				static vector_type load(const float* ptr) { return _mm256_loadu_ps(ptr); }
+				static void store(float* ptr, vector_type a) { _mm256_storeu_ps(ptr, a); }
+				static vector_type set1(float value) { return _mm256_set1_ps(value); }
+				static vector_type add(vector_type a, vector_type b) { return _mm256_add_ps(a, b); }
+				static vector_type mul(vector_type a, vector_type b) { return _mm256_mul_ps(a, b); }
+				static vector_type min(vector_type a, vector_type b) { return _mm256_min_ps(a, b); }
+				static vector_type max(vector_type a, vector_type b) { return _mm256_max_ps(a, b); }
+				static unsigned int eq_mask(vector_type a, vector_type b) { return (unsigned int)_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+			};
+			template<>
+			struct simd_traits<double> {
+				static const bool sc_enabled = true;
+				typedef __m256d vector_type;
+				static const size_t sc_width = 4;
+				static vector_type load(const double* ptr) { return _mm256_loadu_pd(ptr); }
+				static void store(double* ptr, vector_type a) { _mm256_storeu_pd(ptr, a); }
+				static vector_type set1(double value) { return _mm256_set1_pd(value); }
+				static vector_type add(vector_type a, vector_type b) { return _mm256_add_pd(a, b); }
+				static vector_type mul(vector_type a, vector_type b) { return _mm256_mul_pd(a, b); }
+				static vector_type min(vector_type a, vector_type b) { return _mm256_min_pd(a, b); }
+				static vector_type max(vector_type a, vector_type b) { return _mm256_max_pd(a, b); }
+				static unsigned int eq_mask(vector_type a, vector_type b) { return (unsigned int)_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+			};
+#elif defined(MSE_BULK_SSE2)
+			template<>
+			struct simd_traits<float> {
+				static const bool sc_enabled = true;
+				typedef __m128 vector_type;
+				static const size_t sc_width = 4;
+				static vector_type load(const float* ptr) { return _mm_loadu_ps(ptr); }
+				static void store(float* ptr, vector_type a) { _mm_storeu_ps(ptr, a); }
+				static vector_type set1(float value) { return _mm_set1_ps(value); }
+				static vector_type add(vector_type a, vector_type b) { return _mm_add_ps(a, b); }
+				static vector_type mul(vector_type a, vector_type b) { return _mm_mul_ps(a, b); }
+				static vector_type min(vector_type a, vector_type b) { return _mm_min_ps(a, b); }
+				static vector_type max(vector_type a, vector_type b) { return _mm_max_ps(a, b); }
+				static unsigned int eq_mask(vector_type a, vector_type b) { return (unsigned int)_mm_movemask_ps(_mm_cmpeq_ps(a, b)); }
+			};
+			template<>
+			struct simd_traits<double> {
+				static const bool sc_enabled = true;
+				typedef __m128d vector_type;
+				static const size_t sc_width = 2;
+				static vector_type load(const double* ptr) { return _mm_loadu_pd(ptr); }
+				static void store(double* ptr, vector_type a) { _mm_storeu_pd(ptr, a); }
+				static vector_type set1(double value) { return _mm_set1_pd(value); }
+				static vector_type add(vector_type a, vector_type b) { return _mm_add_pd(a, b); }
+				static vector_type mul(vector_type a, vector_type b) { return _mm_mul_pd(a, b); }
+				static vector_type min(vector_type a, vector_type b) { return _mm_min_pd(a, b); }
+				static vector_type max(vector_type a, vector_type b) { return _mm_max_pd(a, b); }
+				static unsigned int eq_mask(vector_type a, vector_type b) { return (unsigned int)_mm_movemask_pd(_mm_cmpeq_pd(a, b)); }
+			};
+#endif // MSE_BULK_AVX
+
+#ifdef MSE_BULK_SSE2
+			template<>
+			struct simd_traits<std::int32_t> {
+				static const bool sc_enabled = true;
+				typedef __m128i vector_type;
+				static const size_t sc_width = 4;
+				static vector_type load(const std::int32_t* ptr) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)); }
+				static void store(std::int32_t* ptr, vector_type a) { _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), a); }
+				static vector_type set1(std::int32_t value) { return _mm_set1_epi32(value); }
+				static vector_type add(vector_type a, vector_type b) { return _mm_add_epi32(a, b); }
+				static vector_type mul(vector_type a, vector_type b) {
+					/* SSE2 has no 32 bit "mullo", so we multiply the even and odd lanes separately and recombine. */
+					const __m128i even_products = _mm_mul_epu32(a, b);
+					const __m128i odd_products = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+					return _mm_unpacklo_epi32(_mm_shuffle_epi32(even_products, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd_products, _MM_SHUFFLE(0, 0, 2, 0)));
+				}
+				static vector_type min(vector_type a, vector_type b) {
+					const __m128i a_is_greater = _mm_cmpgt_epi32(a, b);
+					return _mm_or_si128(_mm_and_si128(a_is_greater, b), _mm_andnot_si128(a_is_greater, a));
+				}
+				static vector_type max(vector_type a, vector_type b) {
+					const __m128i a_is_greater = _mm_cmpgt_epi32(a, b);
+					return _mm_or_si128(_mm_and_si128(a_is_greater, a), _mm_andnot_si128(a_is_greater, b));
+				}
+				static unsigned int eq_mask(vector_type a, vector_type b) { return (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))); }
+			};
+#endif // MSE_BULK_SSE2
+
+			inline size_t num_set_bits(unsigned int mask) {
+				size_t retval = 0;
+				for (; 0 != mask; mask &= (mask - 1)) {
+					retval += 1;
+				}
+				return retval;
+			}
+			inline size_t lowest_set_bit_index(unsigned int mask) {
+				assert(0 != mask);
+				size_t retval = 0;
+				for (; 0 == (mask & 1); mask >>= 1) {
+					retval += 1;
+				}
+				return retval;
+			}
+
+			/* The scalar kernels. These also handle the elements left over after the vectorized part of a SIMD kernel. */
+			template<class _Ty, bool _Simd = simd_traits<_Ty>::sc_enabled>
+			struct kernels {
+				static void fill(_Ty* dest, size_t n, const _Ty& value) {
+					for (size_t i = 0; i < n; i += 1) {
+						dest[i] = value;
+					}
+				}
+				static size_t find(const _Ty* src, size_t n, const _Ty& value) {
+					for (size_t i = 0; i < n; i += 1) {
+						if (value == src[i]) { return i; }
+					}
+					return n;
+				}
+				static size_t count(const _Ty* src, size_t n, const _Ty& value) {
+					size_t retval = 0;
+					for (size_t i = 0; i < n; i += 1) {
+						if (value == src[i]) { retval += 1; }
+					}
+					return retval;
+				}
+				static _Ty min_value(const _Ty* src, size_t n, _Ty init) {
+					for (size_t i = 0; i < n; i += 1) {
+						if (src[i] < init) { init = src[i]; }
+					}
+					return init;
+				}
+				static _Ty max_value(const _Ty* src, size_t n, _Ty init) {
+					for (size_t i = 0; i < n; i += 1) {
+						if (init < src[i]) { init = src[i]; }
+					}
+					return init;
+				}
+				static _Ty sum(const _Ty* src, size_t n, _Ty init) {
+					for (size_t i = 0; i < n; i += 1) {
+						init += src[i];
+					}
+					return init;
+				}
+				static _Ty dot(const _Ty* src1, const _Ty* src2, size_t n, _Ty init) {
+					for (size_t i = 0; i < n; i += 1) {
+						init += src1[i] * src2[i];
+					}
+					return init;
+				}
+			};
+
+			template<class _Ty>
+			struct kernels<_Ty, true> {
+				typedef simd_traits<_Ty> traits;
+				typedef typename traits::vector_type vector_type;
+				typedef kernels<_Ty, false> scalar_kernels;
+				static const size_t sc_width = traits::sc_width;
+
+				static _Ty horizontal_sum(vector_type a) {
+					_Ty lanes[sc_width];
+					traits::store(lanes, a);
+					return scalar_kernels::sum(lanes + 1, sc_width - 1, lanes[0]);
+				}
+
+				static void fill(_Ty* dest, size_t n, const _Ty& value) {
+					const vector_type value_vec = traits::set1(value);
+					size_t i = 0;
+					for (; i + sc_width <= n; i += sc_width) {
+						traits::store(dest + i, value_vec);
+					}
+					scalar_kernels::fill(dest + i, n - i, value);
+				}
+				static size_t find(const _Ty* src, size_t n, const _Ty& value) {
+					const vector_type value_vec = traits::set1(value);
+					size_t i = 0;
+					for (; i + sc_width <= n; i += sc_width) {
+						const unsigned int mask = traits::eq_mask(traits::load(src + i), value_vec);
+						if (0 != mask) { return i + lowest_set_bit_index(mask); }
+					}
+					return i + scalar_kernels::find(src + i, n - i, value);
+				}
+				static size_t count(const _Ty* src, size_t n, const _Ty& value) {
+					const vector_type value_vec = traits::set1(value);
+					size_t retval = 0;
+					size_t i = 0;
+					for (; i + sc_width <= n; i += sc_width) {
+						retval += num_set_bits(traits::eq_mask(traits::load(src + i), value_vec));
+					}
+					return retval + scalar_kernels::count(src + i, n - i, value);
+				}
+				static _Ty min_value(const _Ty* src, size_t n, _Ty init) {
+					size_t i = 0;
+					if (sc_width <= n) {
+						vector_type min_vec = traits::load(src);
+						for (i = sc_width; i + sc_width <= n; i += sc_width) {
+							min_vec = traits::min(min_vec, traits::load(src + i));
+						}
+						_Ty lanes[sc_width];
+						traits::store(lanes, min_vec);
+						init = scalar_kernels::min_value(lanes, sc_width, init);
+					}
+					return scalar_kernels::min_value(src + i, n - i, init);
+				}
+				static _Ty max_value(const _Ty* src, size_t n, _Ty init) {
+					size_t i = 0;
+					if (sc_width <= n) {
+						vector_type max_vec = traits::load(src);
+						for (i = sc_width; i + sc_width <= n; i += sc_width) {
+							max_vec = traits::max(max_vec, traits::load(src + i));
+						}
+						_Ty lanes[sc_width];
+						traits::store(lanes, max_vec);
+						init = scalar_kernels::max_value(lanes, sc_width, init);
+					}
+					return scalar_kernels::max_value(src + i, n - i, init);
+				}
+				static _Ty sum(const _Ty* src, size_t n, _Ty init) {
+					size_t i = 0;
+					if (sc_width <= n) {
+						vector_type sum_vec = traits::load(src);
+						for (i = sc_width; i + sc_width <= n; i += sc_width) {
+							sum_vec = traits::add(sum_vec, traits::load(src + i));
+						}
+						init += horizontal_sum(sum_vec);
+					}
+					return scalar_kernels::sum(src + i, n - i, init);
+				}
+				static _Ty dot(const _Ty* src1, const _Ty* src2, size_t n, _Ty init) {
+					size_t i = 0;
+					if (sc_width <= n) {
+						vector_type sum_vec = traits::mul(traits::load(src1), traits::load(src2));
+						for (i = sc_width; i + sc_width <= n; i += sc_width) {
+							sum_vec = traits::add(sum_vec, traits::mul(traits::load(src1 + i), traits::load(src2 + i)));
+						}
+						init += horizontal_sum(sum_vec);
+					}
+					return scalar_kernels::dot(src1 + i, src2 + i, n - i, init);
+				}
+			};
+
+			template<class _Ty>
+			using kernels_t = kernels<typename std::remove_cv<_Ty>::type>;
+		}
+
+		/* The bulk operations take (contiguous) containers such as msevector<>, msearray<>, mstd::vector<>, mstd::array<>
+		and TXScopeSpan<> (rather than iterators). The container's bounds are checked once per call, after which the
+		elements are processed through native pointers. For float, double and 32 bit int elements the processing uses SSE2
+		(or AVX, if enabled at compile time) vector instructions, other element types use scalar loops. Define
+		MSE_BULK_NO_SIMD to disable the use of vector instructions. */
+
+		template<class _TContainer>
+		void fill(_TContainer&& container, const impl::value_t<_TContainer>& value) {
+			const auto range = impl::make_checked_range(container);
+			impl::kernels_t<impl::element_t<_TContainer>>::fill(range.begin(), range.size(), value);
+		}
+
+		/* Copies the elements of src to the beginning of dest. */
+		template<class _TSrcContainer, class _TDestContainer>
+		void copy(const _TSrcContainer& src, _TDestContainer&& dest) {
+			const auto src_range = impl::make_checked_range(src);
+			const auto dest_range = impl::make_checked_range(dest);
+			if (dest_range.size() < src_range.size()) {
+				MSE_THROW(bulk_range_error("destination is too small - void copy(const _TSrcContainer& src, _TDestContainer& dest) - mse::bulk"));
+			}
+			typedef impl::value_t<_TDestContainer> dest_value_t;
+			if (0 < src_range.size()) {
+				if (std::is_same<impl::value_t<_TSrcContainer>, dest_value_t>::value && std::is_trivially_copyable<dest_value_t>::value) {
+					std::memmove((void*)dest_range.begin(), (const void*)src_range.begin(), src_range.size() * sizeof(dest_value_t));
+				}
+				else {
+					std::copy(src_range.begin(), src_range.begin() + src_range.size(), dest_range.begin());
+				}
+			}
+		}
+
+		/* Returns the index of the first element equal to value, or the container's size() if there is none. */
+		template<class _TContainer>
+		size_t find(const _TContainer& container, const impl::value_t<_TContainer>& value) {
+			const auto range = impl::make_checked_range(container);
+			return impl::kernels_t<impl::element_t<const _TContainer>>::find(range.begin(), range.size(), value);
+		}
+
+		template<class _TContainer>
+		size_t count(const _TContainer& container, const impl::value_t<_TContainer>& value) {
+			const auto range = impl::make_checked_range(container);
+			return impl::kernels_t<impl::element_t<const _TContainer>>::count(range.begin(), range.size(), value);
+		}
+
+		/* min_value() and max_value() throw an exception if the container is empty. If the container contains NaNs, the
+		result is unspecified. */
+		template<class _TContainer>
+		impl::value_t<_TContainer> min_value(const _TContainer& container) {
+			const auto range = impl::make_checked_range(container);
+			if (0 == range.size()) { MSE_THROW(bulk_range_error("empty container - min_value(const _TContainer& container) - mse::bulk")); }
+			return impl::kernels_t<impl::element_t<const _TContainer>>::min_value(range.begin(), range.size(), range.begin()[0]);
+		}
+		template<class _TContainer>
+		impl::value_t<_TContainer> max_value(const _TContainer& container) {
+			const auto range = impl::make_checked_range(container);
+			if (0 == range.size()) { MSE_THROW(bulk_range_error("empty container - max_value(const _TContainer& container) - mse::bulk")); }
+			return impl::kernels_t<impl::element_t<const _TContainer>>::max_value(range.begin(), range.size(), range.begin()[0]);
+		}
+
+		/* Note that the vectorized versions of sum() and dot() add the elements in a different order than a sequential
+		loop would, so with floating point elements the result may differ slightly (in the last bits). */
+		template<class _TContainer>
+		impl::value_t<_TContainer> sum(const _TContainer& container, impl::value_t<_TContainer> init = impl::value_t<_TContainer>()) {
+			const auto range = impl::make_checked_range(container);
+			return impl::kernels_t<impl::element_t<const _TContainer>>::sum(range.begin(), range.size(), init);
+		}
+		/* The containers must be the same size. */
+		template<class _TContainer1, class _TContainer2>
+		impl::value_t<_TContainer1> dot(const _TContainer1& container1, const _TContainer2& container2, impl::value_t<_TContainer1> init = impl::value_t<_TContainer1>()) {
+			static_assert(std::is_same<impl::value_t<_TContainer1>, impl::value_t<_TContainer2>>::value, "the containers must have the same element type");
+			const auto range1 = impl::make_checked_range(container1);
+			const auto range2 = impl::make_checked_range(container2);
+			if (range1.size() != range2.size()) {
+				MSE_THROW(bulk_range_error("size mismatch - dot(const _TContainer1& container1, const _TContainer2& container2, impl::value_t<_TContainer1> init) - mse::bulk"));
+			}
+			return impl::kernels_t<impl::element_t<const _TContainer1>>::dot(range1.begin(), range2.begin(), range1.size(), init);
+		}
+
+		/* Stores function(element) (or function(element1, element2)) for each element of src (or each pair of elements of
+		src1 and src2) in the corresponding element of dest. dest must be at least as large as the source(s). (There's no
+		explicit vector code for arbitrary functions, but the loop operates on native pointers with no bounds checks, so
+		compilers can generally vectorize it when the function is simple enough.) */
+		template<class _TSrcContainer, class _TDestContainer, class _TFunction>
+		void transform(const _TSrcContainer& src, _TDestContainer&& dest, _TFunction function) {
+			const auto src_range = impl::make_checked_range(src);
+			const auto dest_range = impl::make_checked_range(dest);
+			if (dest_range.size() < src_range.size()) {
+				MSE_THROW(bulk_range_error("destination is too small - void transform(const _TSrcContainer& src, _TDestContainer& dest, _TFunction function) - mse::bulk"));
+			}
+			const auto src_ptr = src_range.begin();
+			const auto dest_ptr = dest_range.begin();
+			const size_t n = src_range.size();
+			for (size_t i = 0; i < n; i += 1) {
+				dest_ptr[i] = function(src_ptr[i]);
+			}
+		}
+		template<class _TSrcContainer1, class _TSrcContainer2, class _TDestContainer, class _TFunction>
+		void transform(const _TSrcContainer1& src1, const _TSrcContainer2& src2, _TDestContainer&& dest, _TFunction function) {
+			const auto src1_range = impl::make_checked_range(src1);
+			const auto src2_range = impl::make_checked_range(src2);
+			const auto dest_range = impl::make_checked_range(dest);
+			if (src1_range.size() != src2_range.size()) {
+				MSE_THROW(bulk_range_error("size mismatch - void transform(const _TSrcContainer1& src1, const _TSrcContainer2& src2, _TDestContainer& dest, _TFunction function) - mse::bulk"));
+			}
+			if (dest_range.size() < src1_range.size()) {
+				MSE_THROW(bulk_range_error("destination is too small - void transform(const _TSrcContainer1& src1, const _TSrcContainer2& src2, _TDestContainer& dest, _TFunction function) - mse::bulk"));
+			}
+			const auto src1_ptr = src1_range.begin();
+			const auto src2_ptr = src2_range.begin();
+			const auto dest_ptr = dest_range.begin();
+			const size_t n = src1_range.size();
+			for (size_t i = 0; i < n; i += 1) {
+				dest_ptr[i] = function(src1_ptr[i], src2_ptr[i]);
+			}
+		}
+	}
+}
+
+#undef MSE_THROW
+
+#endif // MSEBULK_H_
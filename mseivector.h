@@ -31,62 +31,63 @@ namespace mse {
 		typedef typename _MV::reference reference;
 		typedef typename _MV::const_reference const_reference;
 
-		const _MV& msevector() const { return (*m_shptr); }
-		_MV& msevector() { return (*m_shptr); }
-		operator const _MV() const { return msevector(); }
-		operator _MV() { return msevector(); }
+		/* (The msevector is moved to the heap (if it isn't already there) so that references to it remain valid.) */
+		const _MV& msevector() const { return (*(m_holder.keep_alive_ptr())); }
+		_MV& msevector() { return (*(m_holder.keep_alive_ptr())); }
+		operator const _MV() const { return (*m_holder); }
+		operator _MV() { return (*m_holder); }
 
-		explicit ivector(const _A& _Al = _A()) : m_shptr(std::make_shared<_MV>(_Al)) {}
-		explicit ivector(size_type _N) : m_shptr(std::make_shared<_MV>(_N)) {}
-		explicit ivector(size_type _N, const _Ty& _V, const _A& _Al = _A()) : m_shptr(std::make_shared<_MV>(_N, _V, _Al)) {}
-		ivector(_MV&& _X) : m_shptr(std::make_shared<_MV>(std::move(_X))) {}
-		ivector(const _MV& _X) : m_shptr(std::make_shared<_MV>(_X)) {}
-		ivector(_Myt&& _X) : m_shptr(std::make_shared<_MV>(std::move(_X.msevector()))) {}
-		ivector(const _Myt& _X) : m_shptr(std::make_shared<_MV>(_X.msevector())) {}
+		explicit ivector(const _A& _Al = _A()) : m_holder(_Al) {}
+		explicit ivector(size_type _N) : m_holder(_N) {}
+		explicit ivector(size_type _N, const _Ty& _V, const _A& _Al = _A()) : m_holder(_N, _V, _Al) {}
+		ivector(_MV&& _X) : m_holder(std::move(_X)) {}
+		ivector(const _MV& _X) : m_holder(_X) {}
+		ivector(_Myt&& _X) : m_holder(std::move(*(_X.m_holder))) {}
+		ivector(const _Myt& _X) : m_holder(*(_X.m_holder)) {}
 		typedef typename _MV::const_iterator _It;
-		ivector(_It _F, _It _L, const _A& _Al = _A()) : m_shptr(std::make_shared<_MV>(_F, _L, _Al)) {}
-		ivector(const _Ty* _F, const _Ty* _L, const _A& _Al = _A()) : m_shptr(std::make_shared<_MV>(_F, _L, _Al)) {}
+		ivector(_It _F, _It _L, const _A& _Al = _A()) : m_holder(_F, _L, _Al) {}
+		ivector(const _Ty* _F, const _Ty* _L, const _A& _Al = _A()) : m_holder(_F, _L, _Al) {}
 		template<class _Iter, class = typename std::enable_if<_mse_Is_iterator<_Iter>::value, void>::type>
-			ivector(_Iter _First, _Iter _Last) : m_shptr(std::make_shared<_MV>(_First, _Last)) {}
+			ivector(_Iter _First, _Iter _Last) : m_holder(_First, _Last) {}
 		template<class _Iter, class = typename std::enable_if<_mse_Is_iterator<_Iter>::value, void>::type>
-			ivector(_Iter _First, _Iter _Last, const _A& _Al) : m_shptr(std::make_shared<_MV>(_First, _Last, _Al)) {}
+			ivector(_Iter _First, _Iter _Last, const _A& _Al) : m_holder(_First, _Last, _Al) {}
 
-		_Myt& operator=(_MV&& _X) { m_shptr->operator=(std::move(_X)); return (*this); }
-		_Myt& operator=(const _MV& _X) { m_shptr->operator=(_X); return (*this); }
-		_Myt& operator=(_Myt&& _X) { m_shptr->operator=(std::move(_X.msevector())); return (*this); }
-		_Myt& operator=(const _Myt& _X) { m_shptr->operator=(_X.msevector()); return (*this); }
-		void reserve(size_type _Count) { m_shptr->reserve(_Count); }
-		void resize(size_type _N, const _Ty& _X = _Ty()) { m_shptr->resize(_N, _X); }
-		typename _MV::const_reference operator[](size_type _P) const { return m_shptr->operator[](_P); }
-		typename _MV::reference operator[](size_type _P) { return m_shptr->operator[](_P); }
-		void push_back(_Ty&& _X) { m_shptr->push_back(std::move(_X)); }
-		void push_back(const _Ty& _X) { m_shptr->push_back(_X); }
-		void pop_back() { m_shptr->pop_back(); }
-		void assign(_It _F, _It _L) { m_shptr->assign(_F, _L); }
-		void assign(size_type _N, const _Ty& _X = _Ty()) { m_shptr->assign(_N, _X); }
+		_Myt& operator=(_MV&& _X) { m_holder->operator=(std::move(_X)); return (*this); }
+		_Myt& operator=(const _MV& _X) { m_holder->operator=(_X); return (*this); }
+		_Myt& operator=(_Myt&& _X) { m_holder->operator=(std::move(*(_X.m_holder))); return (*this); }
+		_Myt& operator=(const _Myt& _X) { m_holder->operator=(*(_X.m_holder)); return (*this); }
+		void reserve(size_type _Count) { m_holder->reserve(_Count); }
+		void resize(size_type _N, const _Ty& _X = _Ty()) { m_holder->resize(_N, _X); }
+		typename _MV::const_reference operator[](size_type _P) const { return m_holder->operator[](_P); }
+		typename _MV::reference operator[](size_type _P) { return m_holder->operator[](_P); }
+		void push_back(_Ty&& _X) { m_holder->push_back(std::move(_X)); }
+		void push_back(const _Ty& _X) { m_holder->push_back(_X); }
+		void pop_back() { m_holder->pop_back(); }
+		void assign(_It _F, _It _L) { m_holder->assign(_F, _L); }
+		void assign(size_type _N, const _Ty& _X = _Ty()) { m_holder->assign(_N, _X); }
 		template<class ..._Valty>
-		void emplace_back(_Valty&& ..._Val) { m_shptr->emplace_back(std::forward<_Valty>(_Val)...); }
-		void clear() { m_shptr->clear(); }
-		void swap(_MV& _X) { m_shptr->swap(_X); }
-		void swap(_Myt& _X) { m_shptr->swap(_X.msevector()); }
+		void emplace_back(_Valty&& ..._Val) { m_holder->emplace_back(std::forward<_Valty>(_Val)...); }
+		void clear() { m_holder->clear(); }
+		void swap(_MV& _X) { m_holder->swap(_X); }
+		void swap(_Myt& _X) { m_holder->swap(*(_X.m_holder)); }
 
-		ivector(_XSTD initializer_list<typename _MV::value_type> _Ilist, const _A& _Al = _A()) : m_shptr(std::make_shared<_MV>(_Ilist, _Al)) {}
-		_Myt& operator=(_XSTD initializer_list<typename _MV::value_type> _Ilist) { m_shptr->operator=(_Ilist); return (*this); }
-		void assign(_XSTD initializer_list<typename _MV::value_type> _Ilist) { m_shptr->assign(_Ilist); }
-		typename _MV::iterator insert(typename _MV::const_iterator _Where, _XSTD initializer_list<typename _MV::value_type> _Ilist) { return m_shptr->insert(_Where, _Ilist); }
+		ivector(_XSTD initializer_list<typename _MV::value_type> _Ilist, const _A& _Al = _A()) : m_holder(_Ilist, _Al) {}
+		_Myt& operator=(_XSTD initializer_list<typename _MV::value_type> _Ilist) { m_holder->operator=(_Ilist); return (*this); }
+		void assign(_XSTD initializer_list<typename _MV::value_type> _Ilist) { m_holder->assign(_Ilist); }
+		typename _MV::iterator insert(typename _MV::const_iterator _Where, _XSTD initializer_list<typename _MV::value_type> _Ilist) { return m_holder->insert(_Where, _Ilist); }
 
-		size_type capacity() const _NOEXCEPT{ return m_shptr->capacity(); }
-		void shrink_to_fit() { m_shptr->shrink_to_fit(); }
-		size_type size() const _NOEXCEPT{ return m_shptr->size(); }
-		size_type max_size() const _NOEXCEPT{ return m_shptr->max_size(); }
-		bool empty() const _NOEXCEPT{ return m_shptr->empty(); }
-		_A get_allocator() const _NOEXCEPT{ return m_shptr->get_allocator(); }
-		typename _MV::const_reference at(size_type _Pos) const { return m_shptr->at(_Pos); }
-		typename _MV::reference at(size_type _Pos) { return m_shptr->at(_Pos); }
-		typename _MV::reference front() { return m_shptr->front(); }
-		typename _MV::const_reference front() const { return m_shptr->front(); }
-		typename _MV::reference back() { return m_shptr->back(); }
-		typename _MV::const_reference back() const { return m_shptr->back(); }
+		size_type capacity() const _NOEXCEPT{ return m_holder->capacity(); }
+		void shrink_to_fit() { m_holder->shrink_to_fit(); }
+		size_type size() const _NOEXCEPT{ return m_holder->size(); }
+		size_type max_size() const _NOEXCEPT{ return m_holder->max_size(); }
+		bool empty() const _NOEXCEPT{ return m_holder->empty(); }
+		_A get_allocator() const _NOEXCEPT{ return m_holder->get_allocator(); }
+		typename _MV::const_reference at(size_type _Pos) const { return m_holder->at(_Pos); }
+		typename _MV::reference at(size_type _Pos) { return m_holder->at(_Pos); }
+		typename _MV::reference front() { return m_holder->front(); }
+		typename _MV::const_reference front() const { return m_holder->front(); }
+		typename _MV::reference back() { return m_holder->back(); }
+		typename _MV::const_reference back() const { return m_holder->back(); }
 
 		class cipointer : public _MV::random_access_const_iterator_base {
 		public:
@@ -97,8 +98,8 @@ namespace mse {
 			typedef typename _MV::mm_const_iterator_type::pointer pointer;
 			typedef typename _MV::mm_const_iterator_type::reference reference;
 
-			cipointer(const _Myt& owner_cref) : m_msevector_cshptr(owner_cref.m_shptr), m_cipointer(*(owner_cref.m_shptr)) {}
-			cipointer(const cipointer& src_cref) : m_msevector_cshptr(src_cref.m_msevector_cshptr), m_cipointer(src_cref.m_cipointer) {}
+			cipointer(const _Myt& owner_cref) : m_msevector_kaptr(owner_cref.m_holder.keep_alive_ptr()), m_cipointer(*m_msevector_kaptr) {}
+			cipointer(const cipointer& src_cref) : m_msevector_kaptr(src_cref.m_msevector_kaptr), m_cipointer(src_cref.m_cipointer) {}
 			~cipointer() {}
 			const typename _MV::cipointer& msevector_cipointer() const { return m_cipointer; }
 			typename _MV::cipointer& msevector_cipointer() { return m_cipointer; }
@@ -143,9 +144,9 @@ namespace mse {
 			void set_to_const_item_pointer(const cipointer& _Right_cref) { msevector_cipointer().set_to_const_item_pointer(_Right_cref.msevector_cipointer()); }
 			msev_size_t position() const { return msevector_cipointer().position(); }
 		private:
-			cipointer(const std::shared_ptr<_MV>& msevector_shptr) : m_msevector_cshptr(msevector_shptr), m_cipointer(*msevector_shptr) {}
-			std::shared_ptr<const _MV> m_msevector_cshptr;
-			/* m_cipointer needs to be declared after m_msevector_cshptr so that it's destructor will be called first. */
+			cipointer(const impl::msevector_keep_alive_ptr<_MV>& msevector_kaptr) : m_msevector_kaptr(msevector_kaptr), m_cipointer(*msevector_kaptr) {}
+			impl::msevector_keep_alive_ptr<_MV> m_msevector_kaptr;
+			/* m_cipointer needs to be declared after m_msevector_kaptr so that it's destructor will be called first. */
 			typename _MV::cipointer m_cipointer;
 			friend class /*_Myt*/ivector<_Ty, _A>;
 			friend class ipointer;
@@ -159,16 +160,16 @@ namespace mse {
 			typedef typename _MV::mm_iterator_type::pointer pointer;
 			typedef typename _MV::mm_iterator_type::reference reference;
 
-			ipointer(_Myt& owner_ref) : m_msevector_shptr(owner_ref.m_shptr), m_ipointer(*(owner_ref.m_shptr)) {}
-			ipointer(const ipointer& src_cref) : m_msevector_shptr(src_cref.m_msevector_shptr), m_ipointer(src_cref.m_ipointer) {}
+			ipointer(_Myt& owner_ref) : m_msevector_kaptr(owner_ref.m_holder.keep_alive_ptr()), m_ipointer(*m_msevector_kaptr) {}
+			ipointer(const ipointer& src_cref) : m_msevector_kaptr(src_cref.m_msevector_kaptr), m_ipointer(src_cref.m_ipointer) {}
 			~ipointer() {}
 			const typename _MV::ipointer& msevector_ipointer() const { return m_ipointer; }
 			typename _MV::ipointer& msevector_ipointer() { return m_ipointer; }
 			const typename _MV::ipointer& mvip() const { return msevector_ipointer(); }
 			typename _MV::ipointer& mvip() { return msevector_ipointer(); }
 			operator cipointer() const {
-				cipointer retval(m_msevector_shptr);
-				assert(m_msevector_shptr);
+				cipointer retval(m_msevector_kaptr);
+				assert(m_msevector_kaptr);
 				retval.set_to_beginning();
 				retval.advance(msev_int(msevector_ipointer().position()));
 				return retval;
@@ -212,8 +213,8 @@ namespace mse {
 			void set_to_item_pointer(const ipointer& _Right_cref) { msevector_ipointer().set_to_item_pointer(_Right_cref.msevector_ipointer()); }
 			msev_size_t position() const { return msevector_ipointer().position(); }
 		private:
-			std::shared_ptr<_MV> m_msevector_shptr;
-			/* m_ipointer needs to be declared after m_msevector_shptr so that it's destructor will be called first. */
+			impl::msevector_keep_alive_ptr<_MV> m_msevector_kaptr;
+			/* m_ipointer needs to be declared after m_msevector_kaptr so that it's destructor will be called first. */
 			typename _MV::ipointer m_ipointer;
 			friend class /*_Myt*/ivector<_Ty, _A>;
 		};
@@ -252,26 +253,26 @@ namespace mse {
 		}
 
 		ivector(const cipointer &start, const cipointer &end, const _A& _Al = _A())
-			: m_shptr(std::make_shared<_MV>(start.msevector_cipointer(), end.msevector_cipointer(), _Al)) {}
+			: m_holder(start.msevector_cipointer(), end.msevector_cipointer(), _Al) {}
 		void assign(const cipointer &start, const cipointer &end) {
-			m_shptr->assign(start.msevector_cipointer(), end.msevector_cipointer());
+			m_holder->assign(start.msevector_cipointer(), end.msevector_cipointer());
 		}
 		void assign_inclusive(const cipointer &first, const cipointer &last) {
-			m_shptr->assign_inclusive(first.msevector_cipointer(), last.msevector_cipointer());
+			m_holder->assign_inclusive(first.msevector_cipointer(), last.msevector_cipointer());
 		}
 		ipointer insert_before(const cipointer &pos, size_type _M, const _Ty& _X) {
-			auto res = m_shptr->insert_before(pos.msevector_cipointer(), _M, _X);
+			auto res = m_holder->insert_before(pos.msevector_cipointer(), _M, _X);
 			ipointer retval(*this); retval.msevector_ipointer() = res;
 			return retval;
 		}
 		ipointer insert_before(const cipointer &pos, _Ty&& _X) {
-			auto res = m_shptr->insert_before(pos.msevector_cipointer(), std::move(_X));
+			auto res = m_holder->insert_before(pos.msevector_cipointer(), std::move(_X));
 			ipointer retval(*this); retval.msevector_ipointer() = res;
 			return retval;
 		}
 		ipointer insert_before(const cipointer &pos, const _Ty& _X = _Ty()) { return insert_before(pos, 1, _X); }
 		ipointer insert_before(const cipointer &pos, const cipointer &start, const cipointer &end) {
-			auto res = m_shptr->insert_before(pos.msevector_cipointer(), start.msevector_cipointer(), end.msevector_cipointer());
+			auto res = m_holder->insert_before(pos.msevector_cipointer(), start.msevector_cipointer(), end.msevector_cipointer());
 			ipointer retval(*this); retval.msevector_ipointer() = res;
 			return retval;
 		}
@@ -280,35 +281,35 @@ namespace mse {
 			return insert_before(pos, first, end);
 		}
 		ipointer insert_before(const cipointer &pos, _XSTD initializer_list<typename _MV::value_type> _Ilist) {	// insert initializer_list
-			auto res = m_shptr->insert_before(pos.msevector_cipointer(), _Ilist);
+			auto res = m_holder->insert_before(pos.msevector_cipointer(), _Ilist);
 			ipointer retval(*this); retval.msevector_ipointer() = res;
 			return retval;
 		}
 		void insert_before(msev_size_t pos, _Ty&& _X) {
-			m_shptr->insert_before(pos, std::move(_X));
+			m_holder->insert_before(pos, std::move(_X));
 		}
 		void insert_before(msev_size_t pos, const _Ty& _X = _Ty()) {
-			m_shptr->insert_before(pos, _X);
+			m_holder->insert_before(pos, _X);
 		}
 		void insert_before(msev_size_t pos, size_type _M, const _Ty& _X) {
-			m_shptr->insert_before(pos, _M, _X);
+			m_holder->insert_before(pos, _M, _X);
 		}
 		void insert_before(msev_size_t pos, _XSTD initializer_list<typename _MV::value_type> _Ilist) {	// insert initializer_list
-			m_shptr->insert_before(pos, _Ilist);
+			m_holder->insert_before(pos, _Ilist);
 		}
 		template<class ..._Valty>
 		ipointer emplace(const cipointer &pos, _Valty&& ..._Val) {
-			auto res = m_shptr->emplace(pos.msevector_cipointer(), std::forward<_Valty>(_Val)...);
+			auto res = m_holder->emplace(pos.msevector_cipointer(), std::forward<_Valty>(_Val)...);
 			ipointer retval = begin(); retval.msevector_ipointer() = res;
 			return retval;
 		}
 		ipointer erase(const ipointer &pos) {
-			auto res = m_shptr->erase(pos.msevector_ipointer());
+			auto res = m_holder->erase(pos.msevector_ipointer());
 			ipointer retval(*this); retval.msevector_ipointer() = res;
 			return retval;
 		}
 		ipointer erase(const ipointer &start, const ipointer &end) {
-			auto res = m_shptr->erase(start.msevector_ipointer(), end.msevector_ipointer());
+			auto res = m_holder->erase(start.msevector_ipointer(), end.msevector_ipointer());
 			ipointer retval(*this); retval.msevector_ipointer() = res;
 			return retval;
 		}
@@ -317,14 +318,15 @@ namespace mse {
 			return erase_inclusive(first, end);
 		}
 		bool operator==(const _Myt& _Right) const {	// test for ivector equality
-			return ((*(_Right.m_shptr)) == (*m_shptr));
+			return ((*(_Right.m_holder)) == (*m_holder));
 		}
 		bool operator<(const _Myt& _Right) const {	// test if _Left < _Right for ivectors
-			return ((*m_shptr) < (*(_Right.m_shptr)));
+			return ((*m_holder) < (*(_Right.m_holder)));
 			}
 
 	private:
-		std::shared_ptr<_MV> m_shptr;
+		/* The msevector is stored inline until an ipointer (that might need to keep it alive) is requested. */
+		impl::msevector_holder<_MV> m_holder;
 	};
 
 	template<class _Ty, class _Alloc> inline bool operator!=(const ivector<_Ty, _Alloc>& _Left,
@@ -0,0 +1,375 @@
+// Copyright (c) 2015 Noah Lopez
+// Use, modification, and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#ifndef MSEMAPPED_H_
+#define MSEMAPPED_H_
+
+#include "msepoly.h"
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <iterator>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif /*NOMINMAX*/
+#include <windows.h>
+#else /*_WIN32*/
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif /*_WIN32*/
+
+#ifdef MSE_CUSTOM_THROW_DEFINITION
+#include <iostream>
+#define MSE_THROW(x) MSE_CUSTOM_THROW_DEFINITION(x)
+#else // MSE_CUSTOM_THROW_DEFINITION
+#define MSE_THROW(x) throw(x)
+#endif // MSE_CUSTOM_THROW_DEFINITION
+
+namespace mse {
+
+	class mapped_range_error : public std::range_error { public:
+		using std::range_error::range_error;
+	};
+	class mapped_file_error : public std::runtime_error { public:
+		using std::runtime_error::runtime_error;
+	};
+
+	namespace impl {
+		/* Owns a (read-only or read-write) memory mapping of a section of a file. */
+		class CMappedFileRegion {
+		public:
+			/* Passed as the byte count to map everything from the offset to the end of the file. */
+			static const size_t to_end_of_file = size_t(-1);
+
+			CMappedFileRegion() {}
+			CMappedFileRegion(const std::string& filename, size_t byte_offset, size_t byte_count, bool read_write) {
+#ifdef _WIN32
+				HANDLE file_handle = ::CreateFileA(filename.c_str(), read_write ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+					FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+				if (INVALID_HANDLE_VALUE == file_handle) { MSE_THROW(mapped_file_error("unable to open file - CMappedFileRegion(const std::string& filename, size_t byte_offset, size_t byte_count, bool read_write) - CMappedFileRegion")); }
+				LARGE_INTEGER file_size_li;
+				if (!::GetFileSizeEx(file_handle, &file_size_li)) {
+					::CloseHandle(file_handle);
+					MSE_THROW(mapped_file_error("unable to obtain file size - CMappedFileRegion(const std::string& filename, size_t byte_offset, size_t byte_count, bool read_write) - CMappedFileRegion"));
+				}
+				const auto file_size = static_cast<unsigned long long>(file_size_li.QuadPart);
+				if (!resolve_byte_count(file_size, byte_offset, byte_count)) {
+					::CloseHandle(file_handle);
+					MSE_THROW(mapped_range_error("section extends beyond the end of the file - CMappedFileRegion(const std::string& filename, size_t byte_offset, size_t byte_count, bool read_write) - CMappedFileRegion"));
+				}
+				if (0 < byte_count) {
+					SYSTEM_INFO system_info;
+					::GetSystemInfo(&system_info);
+					/* The offset of a view must be a multiple of the "allocation granularity". */
+					const size_t mapping_offset = byte_offset - (byte_offset % size_t(system_info.dwAllocationGranularity));
+					const size_t mapping_size = byte_count + (byte_offset - mapping_offset);
+					HANDLE mapping_handle = ::CreateFileMappingA(file_handle, nullptr, read_write ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+					void* mapping_ptr = nullptr;
+					if (nullptr != mapping_handle) {
+						const auto offset64 = static_cast<unsigned long long>(mapping_offset);
+						mapping_ptr = ::MapViewOfFile(mapping_handle, read_write ? FILE_MAP_WRITE : FILE_MAP_READ,
+							DWORD(offset64 >> 32), DWORD(offset64 & 0xffffffffULL), mapping_size);
+						/* The view keeps the mapping (and the file) open. */
+						::CloseHandle(mapping_handle);
+					}
+					::CloseHandle(file_handle);
+					if (nullptr == mapping_ptr) { MSE_THROW(mapped_file_error("unable to map file - CMappedFileRegion(const std::string& filename, size_t byte_offset, size_t byte_count, bool read_write) - CMappedFileRegion")); }
+					set_mapping(mapping_ptr, mapping_size, byte_offset - mapping_offset, byte_count);
+				}
+				else {
+					::CloseHandle(file_handle);
+				}
+#else /*_WIN32*/
+				const int fd = ::open(filename.c_str(), read_write ? O_RDWR : O_RDONLY);
+				if (-1 == fd) { MSE_THROW(mapped_file_error("unable to open file - CMappedFileRegion(const std::string& filename, size_t byte_offset, size_t byte_count, bool read_write) - CMappedFileRegion")); }
+				struct stat file_stat;
+				if (0 != ::fstat(fd, &file_stat)) {
+					::close(fd);
+					MSE_THROW(mapped_file_error("unable to obtain file size - CMappedFileRegion(const std::string& filename, size_t byte_offset, size_t byte_count, bool read_write) - CMappedFileRegion"));
+				}
+				const auto file_size = static_cast<unsigned long long>(file_stat.st_size);
+				if (!resolve_byte_count(file_size, byte_offset, byte_count)) {
+					::close(fd);
+					MSE_THROW(mapped_range_error("section extends beyond the end of the file - CMappedFileRegion(const std::string& filename, size_t byte_offset, size_t byte_count, bool read_write) - CMappedFileRegion"));
+				}
+				if (0 < byte_count) {
+					/* The offset of a mapping must be a multiple of the page size. */
+					const size_t page_size = size_t(::sysconf(_SC_PAGESIZE));
+					const size_t mapping_offset = byte_offset - (byte_offset % page_size);
+					const size_t mapping_size = byte_count + (byte_offset - mapping_offset);
+					void* mapping_ptr = ::mmap(nullptr, mapping_size, read_write ? (PROT_READ | PROT_WRITE) : PROT_READ,
+						MAP_SHARED, fd, off_t(mapping_offset));
+					/* The mapping remains valid after the file descriptor is closed. */
+					::close(fd);
+					if (MAP_FAILED == mapping_ptr) { MSE_THROW(mapped_file_error("unable to map file - CMappedFileRegion(const std::string& filename, size_t byte_offset, size_t byte_count, bool read_write) - CMappedFileRegion")); }
+					set_mapping(mapping_ptr, mapping_size, byte_offset - mapping_offset, byte_count);
+				}
+				else {
+					::close(fd);
+				}
+#endif /*_WIN32*/
+			}
+			CMappedFileRegion(CMappedFileRegion&& src) { swap(src); }
+			CMappedFileRegion& operator=(CMappedFileRegion&& _Right) {
+				CMappedFileRegion(std::move(_Right)).swap(*this);
+				return (*this);
+			}
+			~CMappedFileRegion() { unmap(); }
+			void swap(CMappedFileRegion& _Other) {
+				std::swap(m_mapping_ptr, _Other.m_mapping_ptr);
+				std::swap(m_mapping_size, _Other.m_mapping_size);
+				std::swap(m_data_ptr, _Other.m_data_ptr);
+				std::swap(m_size, _Other.m_size);
+			}
+
+			unsigned char* data() const { return m_data_ptr; }
+			size_t size() const { return m_size; }
+
+			/* Writes any modifications back to the file (without waiting for the mapping to be released). */
+			void flush() const {
+				if (nullptr != m_mapping_ptr) {
+#ifdef _WIN32
+					if (!::FlushViewOfFile(m_mapping_ptr, m_mapping_size)) {
+#else /*_WIN32*/
+					if (0 != ::msync(m_mapping_ptr, m_mapping_size, MS_SYNC)) {
+#endif /*_WIN32*/
+						MSE_THROW(mapped_file_error("unable to flush mapping - void flush() const - CMappedFileRegion"));
+					}
+				}
+			}
+
+		private:
+			CMappedFileRegion(const CMappedFileRegion&) = delete;
+			CMappedFileRegion& operator=(const CMappedFileRegion&) = delete;
+
+			/* Checks that the section lies within the file, and resolves a byte_count of to_end_of_file. */
+			static bool resolve_byte_count(unsigned long long file_size, size_t byte_offset, size_t& byte_count) {
+				if (file_size < byte_offset) { return false; }
+				const unsigned long long available = file_size - byte_offset;
+				if (to_end_of_file == byte_count) {
+					if (static_cast<unsigned long long>(size_t(-1)) < available) { return false; }
+					byte_count = size_t(available);
+					return true;
+				}
+				return (static_cast<unsigned long long>(byte_count) <= available);
+			}
+			void set_mapping(void* mapping_ptr, size_t mapping_size, size_t data_offset, size_t data_size) {
+				m_mapping_ptr = mapping_ptr;
+				m_mapping_size = mapping_size;
+				m_data_ptr = static_cast<unsigned char*>(mapping_ptr) + data_offset;
+				m_size = data_size;
+			}
+			void unmap() {
+				if (nullptr != m_mapping_ptr) {
+#ifdef _WIN32
+					::UnmapViewOfFile(m_mapping_ptr);
+#else /*_WIN32*/
+					::munmap(m_mapping_ptr, m_mapping_size);
+#endif /*_WIN32*/
+				}
+				m_mapping_ptr = nullptr;
+				m_mapping_size = 0;
+				m_data_ptr = nullptr;
+				m_size = 0;
+			}
+
+			void* m_mapping_ptr = nullptr;
+			size_t m_mapping_size = 0;
+			unsigned char* m_data_ptr = nullptr;
+			size_t m_size = 0;
+		};
+	}
+
+	/* TMappedArray<> presents (a section of) a file as a fixed size array of elements, by mapping the file into memory
+	rather than reading it in. So there's no up front copy, and the pages of the file are only loaded (by the OS) as
+	they're accessed. The size and alignment of the section are checked once, when the file is mapped, and element
+	access is bounds checked. By default the array is read-only. With _ReadWrite set to true, modifications to the
+	elements are written to the file. */
+	template<typename _Ty, bool _ReadWrite = false>
+	class TMappedArray {
+	public:
+		static_assert(std::is_trivially_copyable<_Ty>::value, "TMappedArray<> element type must be trivially copyable");
+		typedef TMappedArray<_Ty, _ReadWrite> _Myt;
+		typedef _Ty value_type;
+		typedef size_t size_type;
+		typedef msear_int difference_type;
+		typedef typename std::conditional<_ReadWrite, _Ty, const _Ty>::type element_type;
+		typedef element_type& reference;
+		typedef const _Ty& const_reference;
+		typedef element_type* pointer;
+		typedef const _Ty* const_pointer;
+
+		TMappedArray() {}
+		/* Maps the whole file. The file size must be a multiple of sizeof(_Ty). */
+		explicit TMappedArray(const std::string& filename)
+			: m_region(filename, 0, impl::CMappedFileRegion::to_end_of_file, _ReadWrite) {
+			if (0 != (m_region.size() % sizeof(_Ty))) { MSE_THROW(mapped_range_error("file size is not a multiple of the element size - TMappedArray(const std::string& filename) - TMappedArray")); }
+			m_size = m_region.size() / sizeof(_Ty);
+		}
+		/* Maps count elements starting at the given (byte) offset into the file. The offset must be a multiple of
+		alignof(_Ty). */
+		TMappedArray(const std::string& filename, size_type byte_offset, size_type count)
+			: m_region(filename, aligned_offset(byte_offset), byte_count_of(count), _ReadWrite), m_size(count) {}
+		TMappedArray(_Myt&& src) : m_region(std::move(src.m_region)), m_size(src.m_size) { src.m_size = 0; }
+		_Myt& operator=(_Myt&& _Right) {
+			m_region = std::move(_Right.m_region);
+			m_size = _Right.m_size;
+			_Right.m_size = 0;
+			return (*this);
+		}
+
+		size_type size() const { return m_size; }
+		bool empty() const { return (0 == m_size); }
+		reference operator[](size_type _P) { return (*checked_item_ptr(_P)); }
+		const_reference operator[](size_type _P) const { return (*checked_item_ptr(_P)); }
+		reference at(size_type _P) { return (*checked_item_ptr(_P)); }
+		const_reference at(size_type _P) const { return (*checked_item_ptr(_P)); }
+		reference front() { return (*checked_item_ptr(0)); }
+		const_reference front() const { return (*checked_item_ptr(0)); }
+		reference back() { return (*checked_item_ptr(m_size - 1)); }
+		const_reference back() const { return (*checked_item_ptr(m_size - 1)); }
+		/* Try to avoid using these whenever possible. */
+		pointer data() { return item_ptr(0); }
+		const_pointer data() const { return item_ptr(0); }
+
+		/* Writes any modifications back to the file (without waiting for the array to be destroyed). */
+		void flush() const { m_region.flush(); }
+
+		template<typename _TReference, typename _TPointer>
+		class Tss_iterator_type : public std::iterator<std::random_access_iterator_tag, _Ty, msear_int, _TPointer, _TReference> {
+		public:
+			typedef std::random_access_iterator_tag iterator_category;
+			typedef _Ty value_type;
+			typedef msear_int difference_type;
+			typedef _TPointer pointer;
+			typedef _TReference reference;
+
+			Tss_iterator_type() {}
+			/* Allows ss_iterator_type to be converted to ss_const_iterator_type. */
+			template<typename _TReference2, typename _TPointer2, class = typename std::enable_if<std::is_convertible<_TPointer2, _TPointer>::value, void>::type>
+			Tss_iterator_type(const Tss_iterator_type<_TReference2, _TPointer2>& src_cref) : m_owner_cptr(src_cref.m_owner_cptr), m_index(src_cref.m_index) {}
+
+			void reset() { set_to_end_marker(); }
+			bool points_to_an_item() const { return (m_owner_cptr) && (m_owner_cptr->size() > m_index); }
+			bool points_to_end_marker() const { return !points_to_an_item(); }
+			bool points_to_beginning() const { return (0 == m_index); }
+			/* has_next_item_or_end_marker() is just an alias for points_to_an_item(). */
+			bool has_next_item_or_end_marker() const { return points_to_an_item(); }
+			/* has_next() is just an alias for points_to_an_item() that's familiar to java programmers. */
+			bool has_next() const { return has_next_item_or_end_marker(); }
+			bool has_previous() const { return (m_owner_cptr) && (1 <= m_owner_cptr->size()) && (!points_to_beginning()); }
+			void set_to_beginning() { m_index = 0; }
+			void set_to_end_marker() { m_index = m_owner_cptr ? m_owner_cptr->size() : 0; }
+			void set_to_next() {
+				if (!points_to_an_item()) { MSE_THROW(mapped_range_error("attempt to use invalid iterator - void set_to_next() - ss_iterator_type - TMappedArray")); }
+				m_index += 1;
+			}
+			void set_to_previous() {
+				if (!has_previous()) { MSE_THROW(mapped_range_error("attempt to use invalid iterator - void set_to_previous() - ss_iterator_type - TMappedArray")); }
+				m_index -= 1;
+			}
+			Tss_iterator_type& operator ++() { (*this).set_to_next(); return (*this); }
+			Tss_iterator_type operator++(int) { Tss_iterator_type _Tmp = *this; (*this).set_to_next(); return (_Tmp); }
+			Tss_iterator_type& operator --() { (*this).set_to_previous(); return (*this); }
+			Tss_iterator_type operator--(int) { Tss_iterator_type _Tmp = *this; (*this).set_to_previous(); return (_Tmp); }
+			void advance(difference_type n) {
+				const auto new_index = msear_int(m_index) + n;
+				if ((0 > new_index) || (!m_owner_cptr) || (m_owner_cptr->size() < size_type(new_index))) {
+					MSE_THROW(mapped_range_error("index out of range - void advance(difference_type n) - ss_iterator_type - TMappedArray"));
+				}
+				m_index = size_type(new_index);
+			}
+			void regress(difference_type n) { advance(-n); }
+			Tss_iterator_type& operator +=(difference_type n) { (*this).advance(n); return (*this); }
+			Tss_iterator_type& operator -=(difference_type n) { (*this).regress(n); return (*this); }
+			Tss_iterator_type operator+(difference_type n) const { auto retval = (*this); retval.advance(n); return retval; }
+			Tss_iterator_type operator-(difference_type n) const { return ((*this) + (-n)); }
+			difference_type operator-(const Tss_iterator_type& rhs) const {
+				if (rhs.m_owner_cptr != (*this).m_owner_cptr) { MSE_THROW(mapped_range_error("invalid argument - difference_type operator-(const ss_iterator_type &rhs) const - ss_iterator_type - TMappedArray")); }
+				return (difference_type(m_index) - difference_type(rhs.m_index));
+			}
+			reference operator*() const {
+				if (!m_owner_cptr) { MSE_THROW(mapped_range_error("attempt to use invalid iterator - reference operator*() const - ss_iterator_type - TMappedArray")); }
+				return (*(m_owner_cptr->checked_item_ptr(m_index)));
+			}
+			reference item() const { return operator*(); }
+			reference previous_item() const { return (*((*this) - 1)); }
+			pointer operator->() const { return std::addressof(operator*()); }
+			reference operator[](difference_type _Off) const { return (*((*this) + _Off)); }
+			bool operator==(const Tss_iterator_type& _Right_cref) const { return (0 == ((*this) - _Right_cref)); }
+			bool operator!=(const Tss_iterator_type& _Right_cref) const { return (!((*this) == _Right_cref)); }
+			bool operator<(const Tss_iterator_type& _Right) const { return (0 > ((*this) - _Right)); }
+			bool operator<=(const Tss_iterator_type& _Right) const { return (0 >= ((*this) - _Right)); }
+			bool operator>(const Tss_iterator_type& _Right) const { return (0 < ((*this) - _Right)); }
+			bool operator>=(const Tss_iterator_type& _Right) const { return (0 <= ((*this) - _Right)); }
+			size_type position() const { return m_index; }
+
+		private:
+			Tss_iterator_type(const _Myt* owner_cptr, size_type index) : m_owner_cptr(owner_cptr), m_index(index) {}
+
+			const _Myt* m_owner_cptr = nullptr;
+			size_type m_index = 0;
+
+			template<typename _TReference2, typename _TPointer2> friend class Tss_iterator_type;
+			friend class TMappedArray<_Ty, _ReadWrite>;
+		};
+		typedef Tss_iterator_type<reference, pointer> ss_iterator_type;
+		typedef Tss_iterator_type<const_reference, const_pointer> ss_const_iterator_type;
+		typedef ss_iterator_type iterator;
+		typedef ss_const_iterator_type const_iterator;
+
+		ss_iterator_type ss_begin() { return ss_iterator_type(this, 0); }
+		ss_const_iterator_type ss_begin() const { return ss_const_iterator_type(this, 0); }
+		ss_iterator_type ss_end() { return ss_iterator_type(this, m_size); }
+		ss_const_iterator_type ss_end() const { return ss_const_iterator_type(this, m_size); }
+		ss_const_iterator_type ss_cbegin() const { return ss_const_iterator_type(this, 0); }
+		ss_const_iterator_type ss_cend() const { return ss_const_iterator_type(this, m_size); }
+		iterator begin() { return ss_begin(); }
+		const_iterator begin() const { return ss_cbegin(); }
+		iterator end() { return ss_end(); }
+		const_iterator end() const { return ss_cend(); }
+		const_iterator cbegin() const { return ss_cbegin(); }
+		const_iterator cend() const { return ss_cend(); }
+
+		/* Note that the section refers to the array (which must outlive it). */
+		operator TXScopeRandomAccessConstSection<_Ty>() const {
+			return TXScopeRandomAccessConstSection<_Ty>(TXScopeAnyRandomAccessConstIterator<_Ty>(ss_cbegin()), m_size);
+		}
+
+	private:
+		TMappedArray(const _Myt&) = delete;
+		_Myt& operator=(const _Myt&) = delete;
+
+		static size_type aligned_offset(size_type byte_offset) {
+			if (0 != (byte_offset % alignof(_Ty))) { MSE_THROW(mapped_range_error("misaligned offset - static size_type aligned_offset(size_type byte_offset) - TMappedArray")); }
+			return byte_offset;
+		}
+		static size_type byte_count_of(size_type count) {
+			if ((size_type(-1) - 1) / sizeof(_Ty) < count) { MSE_THROW(mapped_range_error("count too large - static size_type byte_count_of(size_type count) - TMappedArray")); }
+			return count * sizeof(_Ty);
+		}
+		pointer item_ptr(size_type _P) const { return reinterpret_cast<pointer>(m_region.data()) + _P; }
+		pointer checked_item_ptr(size_type _P) const {
+			if (m_size <= _P) { MSE_THROW(mapped_range_error("index out of range - pointer checked_item_ptr(size_type _P) const - TMappedArray")); }
+			return item_ptr(_P);
+		}
+
+		impl::CMappedFileRegion m_region;
+		size_type m_size = 0;
+	};
+}
+
+#undef MSE_THROW
+
+#endif /*ndef MSEMAPPED_H_*/
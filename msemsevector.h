@@ -35,6 +35,7 @@
 #include <memory>
 #include <unordered_map>
 #include <functional>
+#include <algorithm>
 #include <climits>       // ULONG_MAX
 #include <stdexcept>
 
@@ -73,6 +74,11 @@ namespace mse {
 		using std::logic_error::logic_error;
 	};
 
+	namespace impl {
+		/* Defined in msespan.h. */
+		struct xscope_span_maker;
+	}
+
 	/* msev_pointer behaves similar to native pointers. It's a bit safer in that it initializes to
 	nullptr by default and checks for attempted dereference of null pointers. */
 	template<typename _Ty>
@@ -111,6 +117,121 @@ namespace mse {
 		_Ty* m_ptr;
 	};
 
+	/* msev_iterator_slab stores the (msevector owned) iterators that back ipointers and cipointers. Iterators are
+	identified by index, and are stored in fixed size blocks (so they never move), with released slots kept on a free
+	list for reuse. So once the slab has grown to accommodate the maximum number of simultaneously live iterators, no
+	further allocation is required. */
+	template<typename _TItem>
+	class msev_iterator_slab {
+	public:
+		typedef size_t index_type;
+
+		msev_iterator_slab() {}
+		~msev_iterator_slab() {
+			release_all();
+		}
+
+		template<class _TOwner>
+		index_type allocate(_TOwner& owner_ref) {
+			index_type index = 0;
+			if (sc_no_index != m_first_free_index) {
+				index = m_first_free_index;
+				m_first_free_index = slot_ref(index).m_next_free_index;
+			}
+			else {
+				if (m_blocks.size() * sc_block_size <= m_num_slots_used) {
+					m_blocks.emplace_back(new slot_type[sc_block_size]);
+				}
+				index = m_num_slots_used;
+				m_num_slots_used += 1;
+			}
+			auto& slot = slot_ref(index);
+			try {
+				::new (static_cast<void*>(std::addressof(slot.m_storage))) _TItem(owner_ref);
+			}
+			catch (...) {
+				slot.m_next_free_index = m_first_free_index;
+				m_first_free_index = index;
+				throw;
+			}
+			slot.m_is_in_use = true;
+			m_num_in_use += 1;
+			return index;
+		}
+		/* Returns false if the index does not refer to an allocated item. */
+		bool release(index_type index) {
+			if ((m_num_slots_used <= index) || (!(slot_ref(index).m_is_in_use))) {
+				return false;
+			}
+			auto& slot = slot_ref(index);
+			item_ptr(slot)->~_TItem();
+			slot.m_is_in_use = false;
+			slot.m_next_free_index = m_first_free_index;
+			m_first_free_index = index;
+			m_num_in_use -= 1;
+			return true;
+		}
+		void release_all() {
+			for (index_type index = 0; m_num_slots_used > index; index += 1) {
+				auto& slot = slot_ref(index);
+				if (slot.m_is_in_use) {
+					item_ptr(slot)->~_TItem();
+					slot.m_is_in_use = false;
+				}
+			}
+			/* The blocks are retained for reuse. */
+			m_num_slots_used = 0;
+			m_num_in_use = 0;
+			m_first_free_index = sc_no_index;
+		}
+
+		_TItem& at(index_type index) const {
+			assert((m_num_slots_used > index) && slot_ref(index).m_is_in_use);
+			return *item_ptr(slot_ref(index));
+		}
+		/* Calls function(item) for each allocated item. */
+		template<class _TFunction>
+		void for_each(const _TFunction& function) const {
+			for (size_t block_index = 0; m_blocks.size() > block_index; block_index += 1) {
+				const auto block_ptr = m_blocks[block_index].get();
+				const size_t first_index = block_index * sc_block_size;
+				const size_t num_slots = (m_num_slots_used >= first_index + sc_block_size) ? sc_block_size
+					: ((m_num_slots_used > first_index) ? (m_num_slots_used - first_index) : 0);
+				for (size_t i = 0; num_slots > i; i += 1) {
+					if (block_ptr[i].m_is_in_use) {
+						function(*item_ptr(block_ptr[i]));
+					}
+				}
+			}
+		}
+		size_t size() const { return m_num_in_use; }
+		bool empty() const { return (0 == m_num_in_use); }
+
+	private:
+		msev_iterator_slab(const msev_iterator_slab&) = delete;
+		msev_iterator_slab& operator=(const msev_iterator_slab&) = delete;
+
+		static const index_type sc_block_size = 16/*arbitrary*/;
+		static const index_type sc_no_index = index_type(-1);
+
+		struct slot_type {
+			typename std::aligned_storage<sizeof(_TItem), alignof(_TItem)>::type m_storage;
+			index_type m_next_free_index = sc_no_index;
+			bool m_is_in_use = false;
+		};
+		slot_type& slot_ref(index_type index) const {
+			return m_blocks[index / sc_block_size][index % sc_block_size];
+		}
+		static _TItem* item_ptr(slot_type& slot) {
+			return reinterpret_cast<_TItem*>(std::addressof(slot.m_storage));
+		}
+
+		std::vector<std::unique_ptr<slot_type[]>> m_blocks;
+		index_type m_num_slots_used = 0;
+		index_type m_num_in_use = 0;
+		index_type m_first_free_index = sc_no_index;
+	};
+
 #ifndef _XSTD
 #define _XSTD ::std::
 #endif /*_XSTD*/
@@ -177,7 +298,7 @@ namespace mse {
 		}
 		msevector(base_class&& _X) : base_class(std::move(_X)), m_mmitset(*this) { /*m_debug_size = size();*/ }
 		msevector(const base_class& _X) : base_class(_X), m_mmitset(*this) { /*m_debug_size = size();*/ }
-		msevector(_Myt&& _X) : base_class(std::move(_X)), m_mmitset(*this) { /*m_debug_size = size();*/ }
+		msevector(_Myt&& _X) : base_class(std::move(structure_change_checked(_X))), m_mmitset(*this) { /*m_debug_size = size();*/ }
 		msevector(const _Myt& _X) : base_class(_X), m_mmitset(*this) { /*m_debug_size = size();*/ }
 		typedef typename base_class::const_iterator _It;
 		/* Note that safety cannot be guaranteed when using these constructors that take unsafe typename base_class::iterator and/or pointer parameters. */
@@ -193,12 +314,14 @@ namespace mse {
 		//msevector(_Iter _First, _Iter _Last, const typename base_class::_Alloc& _Al) : base_class(_First, _Last, _Al), m_mmitset(*this) { /*m_debug_size = size();*/ }
 		msevector(_Iter _First, _Iter _Last, const _A& _Al) : base_class(_First, _Last, _Al), m_mmitset(*this) { /*m_debug_size = size();*/ }
 		_Myt& operator=(const base_class& _X) {
+			structure_change_check();
 			base_class::operator =(_X);
 			/*m_debug_size = size();*/
 			m_mmitset.reset();
 			return (*this);
 		}
 		_Myt& operator=(_Myt&& _X) {
+			_X.structure_change_check();
 			operator=(std::move(static_cast<base_class&>(_X)));
 			m_mmitset.reset();
 			return (*this);
@@ -210,6 +333,7 @@ namespace mse {
 		}
 		void reserve(size_type _Count)
 		{	// determine new minimum length of allocated storage
+			structure_change_check();
 			auto original_capacity = msev_size_t((*this).capacity());
 
 			base_class::reserve(msev_as_a_size_t(_Count));
@@ -221,6 +345,7 @@ namespace mse {
 			}
 		}
 		void shrink_to_fit() {	// reduce capacity
+			structure_change_check();
 			auto original_capacity = msev_size_t((*this).capacity());
 
 			base_class::shrink_to_fit();
@@ -232,6 +357,7 @@ namespace mse {
 			}
 		}
 		void resize(size_type _N, const _Ty& _X = _Ty()) {
+			structure_change_check();
 			auto original_size = msev_size_t((*this).size());
 			auto original_capacity = msev_size_t((*this).capacity());
 			bool shrinking = (_N < original_size);
@@ -272,6 +398,7 @@ namespace mse {
 			return base_class::back();
 		}
 		void push_back(_Ty&& _X) {
+			structure_change_check();
 			if (m_mmitset.is_empty()) {
 				base_class::push_back(std::move(_X));
 			}
@@ -292,6 +419,7 @@ namespace mse {
 			}
 		}
 		void push_back(const _Ty& _X) {
+			structure_change_check();
 			if (m_mmitset.is_empty()) {
 				base_class::push_back(_X);
 			}
@@ -312,6 +440,7 @@ namespace mse {
 			}
 		}
 		void pop_back() {
+			structure_change_check();
 			if (m_mmitset.is_empty()) {
 				base_class::pop_back();
 			}
@@ -334,17 +463,20 @@ namespace mse {
 			}
 		}
 		void assign(_It _F, _It _L) {
+			structure_change_check();
 			base_class::assign(_F, _L);
 			/*m_debug_size = size();*/
 			m_mmitset.reset();
 		}
 		template<class _Iter>
 		void assign(_Iter _First, _Iter _Last) {	// assign [_First, _Last)
+			structure_change_check();
 			base_class::assign(_First, _Last);
 			/*m_debug_size = size();*/
 			m_mmitset.reset();
 		}
 		void assign(size_type _N, const _Ty& _X = _Ty()) {
+			structure_change_check();
 			base_class::assign(msev_as_a_size_t(_N), _X);
 			/*m_debug_size = size();*/
 			m_mmitset.reset();
@@ -353,6 +485,7 @@ namespace mse {
 			return (emplace(_P, std::move(_X)));
 		}
 		typename base_class::iterator insert(typename base_class::const_iterator _P, const _Ty& _X = _Ty()) {
+			structure_change_check();
 			if (m_mmitset.is_empty()) {
 				typename base_class::iterator retval = base_class::insert(_P, _X);
 				/*m_debug_size = size();*/
@@ -383,6 +516,7 @@ namespace mse {
 
 #if !(defined(GPP4P8_COMPATIBLE))
 		typename base_class::iterator insert(typename base_class::const_iterator _P, size_type _M, const _Ty& _X) {
+			structure_change_check();
 			if (m_mmitset.is_empty()) {
 				typename base_class::iterator retval = base_class::insert(_P, msev_as_a_size_t(_M), _X);
 				/*m_debug_size = size();*/
@@ -414,6 +548,7 @@ namespace mse {
 			//>typename std::enable_if<_mse_Is_iterator<_Iter>::value, typename base_class::iterator>::type
 			, class = _mse_RequireInputIter<_Iter> >
 		typename base_class::iterator insert(typename base_class::const_iterator _Where, _Iter _First, _Iter _Last) {	// insert [_First, _Last) at _Where
+			structure_change_check();
 			if (m_mmitset.is_empty()) {
 				auto retval = base_class::insert(_Where, _First, _Last);
 				/*m_debug_size = size();*/
@@ -450,6 +585,7 @@ namespace mse {
 		void
 			/* g++4.8 seems to be using the c++98 version of this insert function instead of the c++11 version. */
 			insert(typename base_class::/*const_*/iterator _P, size_t _M, const _Ty& _X) {
+				structure_change_check();
 				msev_int di = std::distance(base_class::/*c*/begin(), _P);
 				msev_size_t d = msev_size_t(di);
 				if ((0 > di) || (msev_size_t((*this).size()) < di)) { MSE_THROW(msevector_range_error("index out of range - typename base_class::iterator insert() - msevector")); }
@@ -475,6 +611,7 @@ namespace mse {
 			//>typename std::enable_if<_mse_Is_iterator<_Iter>::value, void>::type
 			, class = _mse_RequireInputIter<_Iter> > void
 		insert(typename base_class::/*const_*/iterator _Where, _Iter _First, _Iter _Last) {	// insert [_First, _Last) at _Where
+				structure_change_check();
 				msev_int di = std::distance(base_class::/*c*/begin(), _Where);
 				msev_size_t d = msev_size_t(di);
 				if ((0 > di) || (msev_size_t((*this).size()) < di)) { MSE_THROW(msevector_range_error("index out of range - typename base_class::iterator insert() - msevector")); }
@@ -503,6 +640,7 @@ namespace mse {
 		template<class ..._Valty>
 		void emplace_back(_Valty&& ..._Val)
 		{	// insert by moving into element at end
+			structure_change_check();
 			if (m_mmitset.is_empty()) {
 				base_class::emplace_back(std::forward<_Valty>(_Val)...);
 				/*m_debug_size = size();*/
@@ -531,6 +669,7 @@ namespace mse {
 		typename base_class::iterator emplace(typename base_class::/*const_*/iterator _Where, _Valty&& ..._Val)
 		{	// insert by moving _Val at _Where
 #endif /*!(defined(GPP4P8_COMPATIBLE))*/
+			structure_change_check();
 
 			if (m_mmitset.is_empty()) {
 				auto retval = base_class::emplace(_Where, std::forward<_Valty>(_Val)...);
@@ -566,6 +705,7 @@ namespace mse {
 			}
 		}
 		typename base_class::iterator erase(typename base_class::const_iterator _P) {
+			structure_change_check();
 			if (m_mmitset.is_empty()) {
 				typename base_class::iterator retval = base_class::erase(_P);
 				/*m_debug_size = size();*/
@@ -598,6 +738,7 @@ namespace mse {
 			}
 		}
 		typename base_class::iterator erase(typename base_class::const_iterator _F, typename base_class::const_iterator _L) {
+			structure_change_check();
 			if (m_mmitset.is_empty()) {
 				typename base_class::iterator retval = base_class::erase(_F, _L);
 				/*m_debug_size = size();*/
@@ -636,20 +777,104 @@ namespace mse {
 			}
 		}
 		void clear() {
+			structure_change_check();
 			base_class::clear();
 			/*m_debug_size = size();*/
 			m_mmitset.reset();
 		}
 		void swap(base_class& _X) {
+			structure_change_check();
 			base_class::swap(_X);
 			/*m_debug_size = size();*/
 			m_mmitset.reset();
 		}
 		void swap(_Myt& _X) {
+			_X.structure_change_check();
 			swap(static_cast<base_class&>(_X));
 			m_mmitset.reset();
 		}
 
+		/* erase_if() and insert_sorted_range() are "batch" operations. Rather than adjusting the live ipointers once per
+		element inserted or removed, they adjust each ipointer once for the whole operation. So for example, filtering N
+		elements with K live ipointers costs O(N + K) rather than O(N * K). */
+
+		/* Removes all the elements for which the predicate returns true, preserving the order of the remaining elements.
+		Returns the number of elements removed. */
+		template<class _TPredicate>
+		size_type erase_if(_TPredicate pred) {
+			structure_change_check();
+			auto original_size = msev_size_t((*this).size());
+			const bool track_iterators = !(m_mmitset.is_empty());
+			std::vector<size_t> new_indices;
+			if (track_iterators) {
+				new_indices.resize(msev_as_a_size_t(original_size) + 1);
+			}
+			size_t write_index = 0;
+			auto base_first = base_class::begin();
+			for (size_t read_index = 0; msev_as_a_size_t(original_size) > read_index; read_index += 1) {
+				if (pred(*(base_first + read_index))) {
+					if (track_iterators) { new_indices[read_index] = mm_iterator_set_type::sc_removed_index; }
+				}
+				else {
+					if (write_index != read_index) {
+						*(base_first + write_index) = std::move(*(base_first + read_index));
+					}
+					if (track_iterators) { new_indices[read_index] = write_index; }
+					write_index += 1;
+				}
+			}
+			auto num_removed = msev_as_a_size_t(original_size) - write_index;
+			if (1 <= num_removed) {
+				base_class::erase(base_first + write_index, base_class::end());
+				/*m_debug_size = size();*/
+				if (track_iterators) {
+					new_indices[msev_as_a_size_t(original_size)] = write_index;
+					m_mmitset.remap_indices(new_indices);
+				}
+			}
+			return size_type(num_removed);
+		}
+
+		/* Inserts the elements of the given range so that, assuming the vector was already sorted (with respect to the given
+		comparison), it remains sorted. The given range doesn't need to be sorted. Inserted elements are placed after any
+		existing elements that are equivalent. */
+		template<class _Iter, class _TCompare = std::less<_Ty> >
+		void insert_sorted_range(const _Iter& _First, const _Iter& _Last, _TCompare comp = _TCompare()) {
+			structure_change_check();
+			base_class new_items(_First, _Last);
+			if (0 == new_items.size()) { return; }
+			std::stable_sort(new_items.begin(), new_items.end(), comp);
+
+			auto original_size = msev_as_a_size_t((*this).size());
+			const bool track_iterators = !(m_mmitset.is_empty());
+			std::vector<size_t> new_indices;
+			if (track_iterators) {
+				new_indices.resize(original_size + 1);
+			}
+			base_class merged(base_class::get_allocator());
+			merged.reserve(original_size + new_items.size());
+			auto old_first = base_class::begin();
+			auto new_it = new_items.begin();
+			for (size_t i = 0; original_size > i; i += 1) {
+				auto& old_item_ref = *(old_first + i);
+				while ((new_items.end() != new_it) && comp(*new_it, old_item_ref)) {
+					merged.push_back(std::move(*new_it));
+					++new_it;
+				}
+				if (track_iterators) { new_indices[i] = merged.size(); }
+				merged.push_back(std::move_if_noexcept(old_item_ref));
+			}
+			for (; new_items.end() != new_it; ++new_it) {
+				merged.push_back(std::move(*new_it));
+			}
+			if (track_iterators) { new_indices[original_size] = merged.size(); }
+			base_class::swap(merged);
+			/*m_debug_size = size();*/
+			if (track_iterators) {
+				m_mmitset.remap_indices(new_indices);
+			}
+		}
+
 		msevector(_XSTD initializer_list<typename base_class::value_type> _Ilist,
 			const _A& _Al = _A())
 			: base_class(_Ilist, _Al), m_mmitset(*this) {	// construct from initializer_list
@@ -661,6 +886,7 @@ namespace mse {
 			return (*this);
 		}
 		void assign(_XSTD initializer_list<typename base_class::value_type> _Ilist) {	// assign initializer_list
+			structure_change_check();
 			base_class::assign(_Ilist);
 			/*m_debug_size = size();*/
 			m_mmitset.reset();
@@ -668,6 +894,7 @@ namespace mse {
 #if defined(GPP4P8_COMPATIBLE)
 		/* g++4.8 seems to be (incorrectly) using the c++98 version of this insert function instead of the c++11 version. */
 		/*typename base_class::iterator*/void insert(typename base_class::/*const_*/iterator _Where, _XSTD initializer_list<typename base_class::value_type> _Ilist) {	// insert initializer_list
+			structure_change_check();
 			msev_int di = std::distance(base_class::/*c*/begin(), _Where);
 			msev_size_t d = msev_size_t(di);
 			if ((0 > di) || (msev_size_t((*this).size()) < di)) { MSE_THROW(msevector_range_error("index out of range - typename base_class::iterator insert() - msevector")); }
@@ -691,6 +918,7 @@ namespace mse {
 		}
 #else /*defined(GPP4P8_COMPATIBLE)*/
 		typename base_class::iterator insert(typename base_class::const_iterator _Where, _XSTD initializer_list<typename base_class::value_type> _Ilist) {	// insert initializer_list
+			structure_change_check();
 			if (m_mmitset.is_empty()) {
 				auto retval = base_class::insert(_Where, _Ilist);
 				/*m_debug_size = size();*/
@@ -918,6 +1146,8 @@ namespace mse {
 			msev_bool m_points_to_an_item = false;
 			msev_size_t m_index = 0;
 			const _Myt* m_owner_cptr = nullptr;
+			/* The (lazy mode) edit log epoch this iterator's index is up to date with. */
+			size_t m_fixup_epoch = 0;
 			friend class mm_iterator_set_type;
 			friend class /*_Myt*/msevector<_Ty, _A>;
 			friend class mm_iterator_type;
@@ -1112,286 +1342,218 @@ namespace mse {
 			msev_bool m_points_to_an_item = false;
 			msev_size_t m_index = 0;
 			_Myt* m_owner_ptr = nullptr;
+			/* The (lazy mode) edit log epoch this iterator's index is up to date with. */
+			size_t m_fixup_epoch = 0;
 			friend class mm_iterator_set_type;
 			friend class /*_Myt*/msevector<_Ty, _A>;
 		};
 
 	private:
-		typedef std::size_t CHashKey1;
 		class mm_const_iterator_handle_type {
 		public:
-			mm_const_iterator_handle_type(const CHashKey1& key_cref, const std::shared_ptr<mm_const_iterator_type>& shptr_cref) : m_shptr(shptr_cref), m_key(key_cref) {}
+			mm_const_iterator_handle_type(size_t index) : m_index(index) {}
 		private:
-			std::shared_ptr<mm_const_iterator_type> m_shptr;
-			CHashKey1 m_key;
+			size_t m_index;
 			friend class /*_Myt*/msevector<_Ty, _A>;
 			friend class mm_iterator_set_type;
 		};
 		class mm_iterator_handle_type {
 		public:
-			mm_iterator_handle_type(const CHashKey1& key_cref, const std::shared_ptr<mm_iterator_type>& shptr_ref) : m_shptr(shptr_ref), m_key(key_cref) {}
+			mm_iterator_handle_type(size_t index) : m_index(index) {}
 		private:
-			std::shared_ptr<mm_iterator_type> m_shptr;
-			CHashKey1 m_key;
+			size_t m_index;
 			friend class /*_Myt*/msevector<_Ty, _A>;
 			friend class mm_iterator_set_type;
 		};
 
 		class mm_iterator_set_type {
 		public:
-			class CMMConstIterators : public std::unordered_map<CHashKey1, std::shared_ptr<mm_const_iterator_type>> {};
-			class CMMIterators : public std::unordered_map<CHashKey1, std::shared_ptr<mm_iterator_type>> {};
-
-			class assignable_CMMConstIterators_value_type : public std::pair<CHashKey1, std::shared_ptr<mm_const_iterator_type>> {
-			public:
-				assignable_CMMConstIterators_value_type() {}
-				assignable_CMMConstIterators_value_type(const typename CMMConstIterators::value_type& src) : std::pair<CHashKey1, std::shared_ptr<mm_iterator_type>>(src.first, src.second) {}
-				assignable_CMMConstIterators_value_type& operator=(const typename CMMConstIterators::value_type& rhs) { (*this).first = rhs.first; (*this).second = rhs.second; return (*this); }
-				operator typename CMMConstIterators::value_type() const { return CMMConstIterators::value_type((*this).first, (*this).second); }
-			};
-			class assignable_CMMIterators_value_type : public std::pair<CHashKey1, std::shared_ptr<mm_iterator_type>> {
-			public:
-				assignable_CMMIterators_value_type() {}
-				assignable_CMMIterators_value_type(const typename CMMIterators::value_type& src) : std::pair<CHashKey1, std::shared_ptr<mm_iterator_type>>(src.first, src.second) {}
-				assignable_CMMIterators_value_type& operator=(const typename CMMIterators::value_type& rhs) { (*this).first = rhs.first; (*this).second = rhs.second; return (*this); }
-				operator typename CMMIterators::value_type() const { return CMMIterators::value_type((*this).first, (*this).second); }
-			};
-
-			~mm_iterator_set_type() {
-				if (!mm_const_fast_mode1()) {
-					delete m_aux_mm_const_iterator_shptrs_ptr;
-				}
-				if (!mm_fast_mode1()) {
-					delete m_aux_mm_iterator_shptrs_ptr;
-				}
-			}
-
-			void apply_to_all_mm_const_iterator_shptrs(const std::function<void(std::shared_ptr<mm_const_iterator_type>&)>& func_obj_ref) {
-				if (!mm_const_fast_mode1()) {
-					for (auto it = (*m_aux_mm_const_iterator_shptrs_ptr).begin(); (*m_aux_mm_const_iterator_shptrs_ptr).end() != it; it++) {
-						func_obj_ref((*it).second);
-					}
-				}
-				else {
-					for (int i = 0; i < m_fm1_num_mm_const_iterators; i += 1) {
-						func_obj_ref(m_fm1_key_mm_const_it_array[i].second);
-					}
-				}
-			}
-			void apply_to_all_mm_iterator_shptrs(const std::function<void(std::shared_ptr<mm_iterator_type>&)>& func_obj_ref) {
-				if (!mm_fast_mode1()) {
-					for (auto it = (*m_aux_mm_iterator_shptrs_ptr).begin(); (*m_aux_mm_iterator_shptrs_ptr).end() != it; it++) {
-						func_obj_ref((*it).second);
-					}
-				}
-				else {
-					for (int i = 0; i < m_fm1_num_mm_iterators; i += 1) {
-						func_obj_ref(m_fm1_key_mm_it_array[i].second);
-					}
-				}
-			}
-			mm_iterator_set_type(_Myt& owner_ref) : m_next_available_key(0), m_owner_ptr(&owner_ref) {}
+			mm_iterator_set_type(_Myt& owner_ref) : m_owner_ptr(&owner_ref) {}
 			void reset() {
-				/* We can use "static" here because the lambda function does not capture any parameters. */
-				static const std::function<void(std::shared_ptr<mm_const_iterator_type>&)> cit_func_obj = [](std::shared_ptr<mm_const_iterator_type>& a) { a->reset(); };
-				apply_to_all_mm_const_iterator_shptrs(cit_func_obj);
-				static const std::function<void(std::shared_ptr<mm_iterator_type>&)> it_func_obj = [](std::shared_ptr<mm_iterator_type>& a) { a->reset(); };
-				apply_to_all_mm_iterator_shptrs(it_func_obj);
+				if (m_lazy_fixup) {
+					record_fixup_edit(fixup_edit_type::reset_all, 0, 0, 0);
+					return;
+				}
+				m_mm_const_iterators.for_each([](mm_const_iterator_type& a) { a.reset(); });
+				m_mm_iterators.for_each([](mm_iterator_type& a) { a.reset(); });
 			}
 			void sync_iterators_to_index() {
 				/* No longer used. Relic from when mm_iterator_type contained a "native" iterator. */
-				/* We can use "static" here because the lambda function does not capture any parameters. */
-				/*
-				static const std::function<void(std::shared_ptr<mm_const_iterator_type>&)> cit_func_obj = [](std::shared_ptr<mm_const_iterator_type>& a) { a->sync_const_iterator_to_index(); };
-				apply_to_all_mm_const_iterator_shptrs(cit_func_obj);
-				static const std::function<void(std::shared_ptr<mm_iterator_type>&)> it_func_obj = [](std::shared_ptr<mm_iterator_type>& a) { a->sync_iterator_to_index(); };
-				apply_to_all_mm_iterator_shptrs(it_func_obj);
-				*/
 			}
+			/* The visitors are passed to the slabs as (inlinable) lambdas rather than via std::function. */
 			void invalidate_inclusive_range(msev_size_t start_index, msev_size_t end_index) {
-				const std::function<void(std::shared_ptr<mm_const_iterator_type>&)> cit_func_obj = [start_index, end_index](std::shared_ptr<mm_const_iterator_type>& a) { a->invalidate_inclusive_range(start_index, end_index); };
-				apply_to_all_mm_const_iterator_shptrs(cit_func_obj);
-				const std::function<void(std::shared_ptr<mm_iterator_type>&)> it_func_obj = [start_index, end_index](std::shared_ptr<mm_iterator_type>& a) { a->invalidate_inclusive_range(start_index, end_index); };
-				apply_to_all_mm_iterator_shptrs(it_func_obj);
+				if (m_lazy_fixup) {
+					record_fixup_edit(fixup_edit_type::invalidate, start_index, end_index, 0);
+					return;
+				}
+				m_mm_const_iterators.for_each([start_index, end_index](mm_const_iterator_type& a) { a.invalidate_inclusive_range(start_index, end_index); });
+				m_mm_iterators.for_each([start_index, end_index](mm_iterator_type& a) { a.invalidate_inclusive_range(start_index, end_index); });
 			}
 			void shift_inclusive_range(msev_size_t start_index, msev_size_t end_index, msev_int shift) {
-				const std::function<void(std::shared_ptr<mm_const_iterator_type>&)> cit_func_obj = [start_index, end_index, shift](std::shared_ptr<mm_const_iterator_type>& a) { a->shift_inclusive_range(start_index, end_index, shift); };
-				apply_to_all_mm_const_iterator_shptrs(cit_func_obj);
-				const std::function<void(std::shared_ptr<mm_iterator_type>&)> it_func_obj = [start_index, end_index, shift](std::shared_ptr<mm_iterator_type>& a) { a->shift_inclusive_range(start_index, end_index, shift); };
-				apply_to_all_mm_iterator_shptrs(it_func_obj);
+				if (m_lazy_fixup) {
+					record_fixup_edit(fixup_edit_type::shift, start_index, end_index, shift);
+					return;
+				}
+				m_mm_const_iterators.for_each([start_index, end_index, shift](mm_const_iterator_type& a) { a.shift_inclusive_range(start_index, end_index, shift); });
+				m_mm_iterators.for_each([start_index, end_index, shift](mm_iterator_type& a) { a.shift_inclusive_range(start_index, end_index, shift); });
 			}
 			bool is_empty() const {
-				if (mm_const_fast_mode1()) {
-					if (1 <= m_fm1_num_mm_const_iterators) {
-						return false;
-					}
-				}
-				else {
-					if (1 <= m_aux_mm_const_iterator_shptrs_ptr->size()) {
-						return false;
-					}
-				}
-				if (mm_fast_mode1()) {
-					if (1 <= m_fm1_num_mm_iterators) {
-						return false;
-					}
-				}
-				else {
-					if (1 <= m_aux_mm_iterator_shptrs_ptr->size()) {
-						return false;
-					}
-				}
-				return true;
+				return (m_mm_const_iterators.empty() && m_mm_iterators.empty());
 			}
 
-			mm_const_iterator_handle_type allocate_new_const_item_pointer() {
-				//auto shptr = std::shared_ptr<mm_const_iterator_type>(new mm_const_iterator_type(*m_owner_ptr));
-				auto shptr = std::make_shared<mm_const_iterator_type>(*m_owner_ptr);
-				auto key = m_next_available_key; m_next_available_key++;
-				mm_const_iterator_handle_type retval(key, shptr);
-				typename CMMConstIterators::value_type new_item(key, shptr);
-				if (!mm_const_fast_mode1()) {
-					(*m_aux_mm_const_iterator_shptrs_ptr).insert(new_item);
-				} else {
-					if (sc_fm1_max_mm_iterators == m_fm1_num_mm_const_iterators) {
-						/* Too many items. Initiate and switch to slow mode. */
-						/* Initialize slow storage. */
-						m_aux_mm_const_iterator_shptrs_ptr = new CMMConstIterators();
-						/* First copy the items from fast storage to slow storage. */
-						for (int i = 0; i < sc_fm1_max_mm_iterators; i += 1) {
-							(*m_aux_mm_const_iterator_shptrs_ptr).insert(m_fm1_key_mm_const_it_array[i]);
-						}
-						/* Add the new items to slow storage. */
-						(*m_aux_mm_const_iterator_shptrs_ptr).insert(new_item);
-					}
-					else {
-						m_fm1_key_mm_const_it_array[m_fm1_num_mm_const_iterators] = new_item;
-						m_fm1_num_mm_const_iterators += 1;
-					}
+			static const size_t sc_removed_index = size_t(-1);
+			/* Moves every iterator to the index given by the corresponding element of new_indices (the last element being the new
+			index of the end marker), or resets it if that element is sc_removed_index. */
+			void remap_indices(const std::vector<size_t>& new_indices) {
+				/* Any pending (lazy mode) edits need to be applied first. */
+				compact_fixup_log();
+				const auto new_size = msev_size_t(m_owner_ptr->size());
+				m_mm_const_iterators.for_each([&new_indices, new_size](mm_const_iterator_type& a) { remap_index(a, new_indices, new_size); });
+				m_mm_iterators.for_each([&new_indices, new_size](mm_iterator_type& a) { remap_index(a, new_indices, new_size); });
+			}
+
+			/* In lazy mode, rather than visiting every iterator, mutations just append an entry to an edit log and advance the
+			epoch counter. Each iterator replays the edits it hasn't yet seen the next time it is accessed. When the log grows
+			too long, it is compacted by bringing all the iterators up to date in one pass. */
+			void set_lazy_fixup(bool lazy) {
+				if (lazy == m_lazy_fixup) { return; }
+				if (!lazy) {
+					compact_fixup_log();
 				}
-				return retval;
+				m_lazy_fixup = lazy;
+			}
+			bool lazy_fixup() const { return m_lazy_fixup; }
+			mm_const_iterator_handle_type allocate_new_const_item_pointer() {
+				auto index = m_mm_const_iterators.allocate(*m_owner_ptr);
+				m_mm_const_iterators.at(index).m_fixup_epoch = m_fixup_epoch;
+				return mm_const_iterator_handle_type(index);
 			}
 			void release_const_item_pointer(mm_const_iterator_handle_type handle) {
-				if (!mm_const_fast_mode1()) {
-					auto it = (*m_aux_mm_const_iterator_shptrs_ptr).find(handle.m_key);
-					if ((*m_aux_mm_const_iterator_shptrs_ptr).end() != it) {
-						(*m_aux_mm_const_iterator_shptrs_ptr).erase(it);
-					}
-					else {
-						/* Do we need to throw here? */
-						MSE_THROW(msevector_range_error("invalid handle - void release_aux_mm_const_iterator(mm_const_iterator_handle_type handle) - msevector::mm_iterator_set_type"));
-					}
-				}
-				else {
-					int found_index = -1;
-					for (int i = 0; i < m_fm1_num_mm_const_iterators; i += 1) {
-						if (handle.m_key == m_fm1_key_mm_const_it_array[i].first) {
-							found_index = i;
-							break;
-						}
-					}
-					if (0 <= found_index) {
-						m_fm1_num_mm_const_iterators -= 1;
-						assert(0 <= m_fm1_num_mm_const_iterators);
-						for (int j = found_index; j < m_fm1_num_mm_const_iterators; j += 1) {
-							m_fm1_key_mm_const_it_array[j] = m_fm1_key_mm_const_it_array[j + 1];
-						}
-					}
-					else {
-						/* Do we need to throw here? */
-						MSE_THROW(msevector_range_error("invalid handle - void release_aux_mm_const_iterator(mm_const_iterator_handle_type handle) - msevector::mm_iterator_set_type"));
-					}
+				if (!m_mm_const_iterators.release(handle.m_index)) {
+					/* Do we need to throw here? */
+					MSE_THROW(msevector_range_error("invalid handle - void release_aux_mm_const_iterator(mm_const_iterator_handle_type handle) - msevector::mm_iterator_set_type"));
 				}
+				discard_fixup_log_if_unused();
 			}
 
 			mm_iterator_handle_type allocate_new_item_pointer() {
-				//auto shptr = std::shared_ptr<mm_iterator_type>(new mm_iterator_type(*m_owner_ptr));
-				auto shptr = std::make_shared<mm_iterator_type>(*m_owner_ptr);
-				auto key = m_next_available_key; m_next_available_key++;
-				mm_iterator_handle_type retval(key, shptr);
-				typename CMMIterators::value_type new_item(key, shptr);
-				if (!mm_fast_mode1()) {
-					(*m_aux_mm_iterator_shptrs_ptr).insert(new_item);
-				}
-				else {
-					if (sc_fm1_max_mm_iterators == m_fm1_num_mm_iterators) {
-						/* Too many items. Initiate and switch to slow mode. */
-						/* Initialize slow storage. */
-						m_aux_mm_iterator_shptrs_ptr = new CMMIterators();
-						/* First copy the items from fast storage to slow storage. */
-						for (int i = 0; i < sc_fm1_max_mm_iterators; i += 1) {
-							(*m_aux_mm_iterator_shptrs_ptr).insert(m_fm1_key_mm_it_array[i]);
-						}
-						/* Add the new items to slow storage. */
-						(*m_aux_mm_iterator_shptrs_ptr).insert(new_item);
-					}
-					else {
-						m_fm1_key_mm_it_array[m_fm1_num_mm_iterators] = new_item;
-						m_fm1_num_mm_iterators += 1;
-					}
-				}
-				return retval;
+				auto index = m_mm_iterators.allocate(*m_owner_ptr);
+				m_mm_iterators.at(index).m_fixup_epoch = m_fixup_epoch;
+				return mm_iterator_handle_type(index);
 			}
 			void release_item_pointer(mm_iterator_handle_type handle) {
-				if (!mm_fast_mode1()) {
-					auto it = (*m_aux_mm_iterator_shptrs_ptr).find(handle.m_key);
-					if ((*m_aux_mm_iterator_shptrs_ptr).end() != it) {
-						(*m_aux_mm_iterator_shptrs_ptr).erase(it);
-					}
-					else {
-						/* Do we need to throw here? */
-						MSE_THROW(msevector_range_error("invalid handle - void release_aux_mm_iterator(mm_iterator_handle_type handle) - msevector::mm_iterator_set_type"));
-					}
-				}
-				else {
-					int found_index = -1;
-					for (int i = 0; i < m_fm1_num_mm_iterators; i += 1) {
-						if (handle.m_key == m_fm1_key_mm_it_array[i].first) {
-							found_index = i;
-							break;
-						}
-					}
-					if (0 <= found_index) {
-						m_fm1_num_mm_iterators -= 1;
-						assert(0 <= m_fm1_num_mm_iterators);
-						for (int j = found_index; j < m_fm1_num_mm_iterators; j += 1) {
-							m_fm1_key_mm_it_array[j] = m_fm1_key_mm_it_array[j + 1];
-						}
-					}
-					else {
-						/* Do we need to throw here? */
-						MSE_THROW(msevector_range_error("invalid handle - void release_aux_mm_iterator(mm_iterator_handle_type handle) - msevector::mm_iterator_set_type"));
-					}
+				if (!m_mm_iterators.release(handle.m_index)) {
+					/* Do we need to throw here? */
+					MSE_THROW(msevector_range_error("invalid handle - void release_aux_mm_iterator(mm_iterator_handle_type handle) - msevector::mm_iterator_set_type"));
 				}
+				discard_fixup_log_if_unused();
 			}
 			void release_all_item_pointers() {
-				if (!mm_fast_mode1()) {
-					(*m_aux_mm_iterator_shptrs_ptr).clear();
-				}
-				else {
-					for (int i = 0; i < m_fm1_num_mm_iterators; i += 1) {
-						m_fm1_key_mm_it_array[i] = assignable_CMMIterators_value_type();
-					}
-					m_fm1_num_mm_iterators = 0;
-				}
+				m_mm_iterators.release_all();
+				discard_fixup_log_if_unused();
 			}
 			mm_const_iterator_type &const_item_pointer(mm_const_iterator_handle_type handle) const {
-				return (*(handle.m_shptr));
+				auto& item_ref = m_mm_const_iterators.at(handle.m_index);
+				if (m_fixup_epoch != item_ref.m_fixup_epoch) { replay_fixup_edits(item_ref); }
+				return item_ref;
 			}
 			mm_iterator_type &item_pointer(mm_iterator_handle_type handle) {
-				return (*(handle.m_shptr));
+				auto& item_ref = m_mm_iterators.at(handle.m_index);
+				if (m_fixup_epoch != item_ref.m_fixup_epoch) { replay_fixup_edits(item_ref); }
+				return item_ref;
 			}
 
 		private:
 			void release_all_const_item_pointers() {
-				if (!mm_const_fast_mode1()) {
-					(*m_aux_mm_const_iterator_shptrs_ptr).clear();
+				m_mm_const_iterators.release_all();
+				discard_fixup_log_if_unused();
+			}
+
+			class fixup_edit_type {
+			public:
+				enum kind_type : unsigned char { invalidate, shift, reset_all };
+				msev_size_t m_index_of_first;
+				msev_size_t m_index_of_last;
+				msev_int m_shift;
+				/* The size of the container at the time of the edit. */
+				msev_size_t m_size;
+				kind_type m_kind;
+			};
+			static const size_t sc_min_fixup_log_capacity = 4096;
+
+			void record_fixup_edit(typename fixup_edit_type::kind_type kind, msev_size_t index_of_first, msev_size_t index_of_last, msev_int shift) {
+				if (is_empty()) { return; }
+				const auto num_iterators = m_mm_const_iterators.size() + m_mm_iterators.size();
+				if ((sc_min_fixup_log_capacity <= m_fixup_log.size()) && (4 * num_iterators <= m_fixup_log.size())) {
+					/* The log's memory is bounded (to a multiple of the number of iterators) by occasionally bringing the
+					iterators that haven't been used (or released) in a while up to date. */
+					compact_fixup_log();
+				}
+				fixup_edit_type edit;
+				edit.m_index_of_first = index_of_first;
+				edit.m_index_of_last = index_of_last;
+				edit.m_shift = shift;
+				edit.m_size = msev_size_t(m_owner_ptr->size());
+				edit.m_kind = kind;
+				m_fixup_log.push_back(edit);
+				m_fixup_epoch += 1;
+			}
+			/* Applies the edits recorded since the iterator's epoch. Edits are applied just as the eager fix-up would have applied
+			them, but using the container size recorded with the edit rather than the current one. */
+			template<typename _TIterator>
+			void replay_fixup_edits(_TIterator& iter_ref) const {
+				assert(m_fixup_log_base_epoch <= iter_ref.m_fixup_epoch);
+				for (size_t i = iter_ref.m_fixup_epoch - m_fixup_log_base_epoch; m_fixup_log.size() > i; i += 1) {
+					const auto& edit = m_fixup_log[i];
+					if (fixup_edit_type::reset_all == edit.m_kind) {
+						iter_ref.m_index = edit.m_size;
+						iter_ref.m_points_to_an_item = false;
+					}
+					else if ((edit.m_index_of_first <= iter_ref.m_index) && (edit.m_index_of_last >= iter_ref.m_index)) {
+						if (fixup_edit_type::invalidate == edit.m_kind) {
+							iter_ref.m_index = edit.m_size;
+							iter_ref.m_points_to_an_item = false;
+						}
+						else {
+							auto new_index = msev_int(iter_ref.m_index) + edit.m_shift;
+							if ((0 > new_index) || (msev_int(edit.m_size) < new_index)) {
+								/* The eager fix-up would have thrown an exception here (from within the mutating operation). There's
+								no one to report the error to now, so we just reset the iterator. */
+								assert(false);
+								iter_ref.m_index = edit.m_size;
+								iter_ref.m_points_to_an_item = false;
+							}
+							else {
+								iter_ref.m_index = msev_size_t(new_index);
+							}
+						}
+					}
+				}
+				iter_ref.m_fixup_epoch = m_fixup_epoch;
+			}
+			void compact_fixup_log() {
+				if (m_fixup_log.empty()) { return; }
+				m_mm_const_iterators.for_each([this](mm_const_iterator_type& a) { if (m_fixup_epoch != a.m_fixup_epoch) { replay_fixup_edits(a); } });
+				m_mm_iterators.for_each([this](mm_iterator_type& a) { if (m_fixup_epoch != a.m_fixup_epoch) { replay_fixup_edits(a); } });
+				m_fixup_log.clear();
+				m_fixup_log_base_epoch = m_fixup_epoch;
+			}
+			template<typename _TIterator>
+			static void remap_index(_TIterator& iter_ref, const std::vector<size_t>& new_indices, msev_size_t new_size) {
+				assert(new_indices.size() > msev_as_a_size_t(iter_ref.m_index));
+				const auto new_index = new_indices[msev_as_a_size_t(iter_ref.m_index)];
+				if (sc_removed_index == new_index) {
+					iter_ref.m_index = new_size;
+					iter_ref.m_points_to_an_item = false;
 				}
 				else {
-					for (int i = 0; i < m_fm1_num_mm_const_iterators; i += 1) {
-						m_fm1_key_mm_const_it_array[i] = assignable_CMMConstIterators_value_type();
-					}
-					m_fm1_num_mm_const_iterators = 0;
+					iter_ref.m_index = msev_size_t(new_index);
+				}
+			}
+			void discard_fixup_log_if_unused() {
+				if (is_empty() && (!m_fixup_log.empty())) {
+					m_fixup_log.clear();
+					m_fixup_log_base_epoch = m_fixup_epoch;
 				}
 			}
 
@@ -1407,27 +1569,38 @@ namespace mse {
 			mm_iterator_set_type(const mm_iterator_set_type& src) { /* see above */ }
 			mm_iterator_set_type(const mm_iterator_set_type&& src) { /* see above */ }
 
-			CHashKey1 m_next_available_key = 0;
-
-			static const int sc_fm1_max_mm_iterators = 6/*arbitrary*/;
-
-			bool mm_const_fast_mode1() const { return (nullptr == m_aux_mm_const_iterator_shptrs_ptr); }
-			int m_fm1_num_mm_const_iterators = 0;
-			assignable_CMMConstIterators_value_type m_fm1_key_mm_const_it_array[sc_fm1_max_mm_iterators];
-			CMMConstIterators* m_aux_mm_const_iterator_shptrs_ptr = nullptr;
-
-			bool mm_fast_mode1() const { return (nullptr == m_aux_mm_iterator_shptrs_ptr); }
-			int m_fm1_num_mm_iterators = 0;
-			assignable_CMMIterators_value_type m_fm1_key_mm_it_array[sc_fm1_max_mm_iterators];
-			CMMIterators* m_aux_mm_iterator_shptrs_ptr = nullptr;
+			msev_iterator_slab<mm_const_iterator_type> m_mm_const_iterators;
+			msev_iterator_slab<mm_iterator_type> m_mm_iterators;
 
 			_Myt* m_owner_ptr = nullptr;
 
+			bool m_lazy_fixup = false;
+			size_t m_fixup_epoch = 0;
+			/* The epoch corresponding to the first entry in the edit log. */
+			size_t m_fixup_log_base_epoch = 0;
+			std::vector<fixup_edit_type> m_fixup_log;
+
 			friend class /*_Myt*/msevector<_Ty, _A>;
 		};
 		mutable mm_iterator_set_type m_mmitset;
 
+		/* While an xscope span (see msespan.h) of the vector exists, operations that could change the vector's size or relocate
+		its elements are not permitted. Every such operation calls this function first, so it's also where the "structure
+		generation" gets incremented. */
+		void structure_change_check() const {
+			if (0 != m_structure_lock_count) { MSE_THROW(msevector_range_error("structure change not permitted while a span of the vector exists - void structure_change_check() const - msevector")); }
+			m_structure_generation += 1;
+		}
+		static _Myt& structure_change_checked(_Myt& _X) { _X.structure_change_check(); return _X; }
+		mutable size_t m_structure_lock_count = 0;
+		mutable size_t m_structure_generation = 0;
+		friend struct mse::impl::xscope_span_maker;
+
 	public:
+		/* Incremented by every operation that could change the vector's size or relocate its elements. So (raw) pointers to
+		elements obtained while the generation had a given value remain valid as long as the generation retains that value. */
+		size_t structure_generation() const { return m_structure_generation; }
+
 		mm_const_iterator_type &const_item_pointer(mm_const_iterator_handle_type handle) const {
 			return m_mmitset.const_item_pointer(handle);
 		}
@@ -1455,21 +1628,16 @@ namespace mse {
 			typedef typename mm_const_iterator_type::reference reference;
 			typedef typename mm_const_iterator_type::const_reference const_reference;
 
-			cipointer(const _Myt& owner_cref) : m_owner_cptr(&owner_cref) {
-				mm_const_iterator_handle_type handle = m_owner_cptr->allocate_new_const_item_pointer();
-				m_handle_shptr = std::make_shared<mm_const_iterator_handle_type>(handle);
-			}
-			cipointer(const cipointer& src_cref) : m_owner_cptr(src_cref.m_owner_cptr) {
-				mm_const_iterator_handle_type handle = m_owner_cptr->allocate_new_const_item_pointer();
-				m_handle_shptr = std::make_shared<mm_const_iterator_handle_type>(handle);
+			cipointer(const _Myt& owner_cref) : m_owner_cptr(&owner_cref), m_handle(m_owner_cptr->allocate_new_const_item_pointer()) {}
+			cipointer(const cipointer& src_cref) : m_owner_cptr(src_cref.m_owner_cptr), m_handle(m_owner_cptr->allocate_new_const_item_pointer()) {
 				const_item_pointer() = src_cref.const_item_pointer();
 			}
 			~cipointer() {
-				m_owner_cptr->release_const_item_pointer(*m_handle_shptr);
+				m_owner_cptr->release_const_item_pointer(m_handle);
 			}
-			mm_const_iterator_type& const_item_pointer() const { return m_owner_cptr->const_item_pointer(*m_handle_shptr); }
+			mm_const_iterator_type& const_item_pointer() const { return m_owner_cptr->const_item_pointer(m_handle); }
 			mm_const_iterator_type& cip() const { return const_item_pointer(); }
-			//const mm_const_iterator_handle_type& handle() const { return (*m_handle_shptr); }
+			//const mm_const_iterator_handle_type& handle() const { return m_handle; }
 
 			void reset() { const_item_pointer().reset(); }
 			bool points_to_an_item() const { return const_item_pointer().points_to_an_item(); }
@@ -1511,7 +1679,9 @@ namespace mse {
 			msev_size_t position() const { return const_item_pointer().position(); }
 		private:
 			const _Myt* m_owner_cptr = nullptr;
-			std::shared_ptr<mm_const_iterator_handle_type> m_handle_shptr;
+			/* The handle is just an index into the owner's iterator set, so creating or copying a cipointer doesn't
+			(normally) require any heap allocation. */
+			mm_const_iterator_handle_type m_handle;
 			friend class /*_Myt*/msevector<_Ty, _A>;
 		};
 		class ipointer : public random_access_iterator_base {
@@ -1523,21 +1693,16 @@ namespace mse {
 			typedef typename mm_iterator_type::pointer pointer;
 			typedef typename mm_iterator_type::reference reference;
 
-			ipointer(_Myt& owner_ref) : m_owner_ptr(&owner_ref) {
-				mm_iterator_handle_type handle = m_owner_ptr->allocate_new_item_pointer();
-				m_handle_shptr = std::make_shared<mm_iterator_handle_type>(handle);
-			}
-			ipointer(const ipointer& src_cref) : m_owner_ptr(src_cref.m_owner_ptr) {
-				mm_iterator_handle_type handle = m_owner_ptr->allocate_new_item_pointer();
-				m_handle_shptr = std::make_shared<mm_iterator_handle_type>(handle);
+			ipointer(_Myt& owner_ref) : m_owner_ptr(&owner_ref), m_handle(m_owner_ptr->allocate_new_item_pointer()) {}
+			ipointer(const ipointer& src_cref) : m_owner_ptr(src_cref.m_owner_ptr), m_handle(m_owner_ptr->allocate_new_item_pointer()) {
 				item_pointer() = src_cref.item_pointer();
 			}
 			~ipointer() {
-				m_owner_ptr->release_item_pointer(*m_handle_shptr);
+				m_owner_ptr->release_item_pointer(m_handle);
 			}
-			mm_iterator_type& item_pointer() const { return m_owner_ptr->item_pointer(*m_handle_shptr); }
+			mm_iterator_type& item_pointer() const { return m_owner_ptr->item_pointer(m_handle); }
 			mm_iterator_type& ip() const { return item_pointer(); }
-			//const mm_iterator_handle_type& handle() const { return (*m_handle_shptr); }
+			//const mm_iterator_handle_type& handle() const { return m_handle; }
 			operator cipointer() const {
 				cipointer retval(*m_owner_ptr);
 				retval.const_item_pointer().set_to_beginning();
@@ -1585,10 +1750,18 @@ namespace mse {
 			msev_size_t position() const { return item_pointer().position(); }
 		private:
 			_Myt* m_owner_ptr = nullptr;
-			std::shared_ptr<mm_iterator_handle_type> m_handle_shptr;
+			/* See the comment in cipointer. */
+			mm_iterator_handle_type m_handle;
 			friend class /*_Myt*/msevector<_Ty, _A>;
 		};
 
+		/* By default, each insertion or removal immediately adjusts every live ipointer and cipointer. In "lazy" fix-up mode
+		the operation instead just records the edit, and each ipointer applies the edits it missed the next time it's used. This
+		can be significantly faster when there are many ipointers but few of them are used between modifications. (The mode is
+		not copied along with the vector's contents.) */
+		void set_lazy_ipointer_fixup(bool lazy) { m_mmitset.set_lazy_fixup(lazy); }
+		bool lazy_ipointer_fixup() const { return m_mmitset.lazy_fixup(); }
+
 		ipointer ibegin() {	// return ipointer for beginning of mutable sequence
 			ipointer retval(*this);
 			retval.set_to_beginning();
@@ -1750,6 +1923,7 @@ namespace mse {
 #endif /*!(defined(GPP4P8_COMPATIBLE))*/
 			if (pos.m_owner_cptr != this) { MSE_THROW(msevector_range_error("invalid arguments - void emplace() - msevector")); }
 			typename base_class::const_iterator _P = pos;
+			structure_change_check();
 			auto retval = base_class::emplace(_P, std::forward<_Valty>(_Val)...);
 		}
 		template<class ..._Valty>
@@ -2426,6 +2600,263 @@ namespace mse {
 		}
 	};
 
+	namespace impl {
+		template<class _Ty, size_t _InlineCapacity>
+		class msev_inline_storage {
+		public:
+			_Ty* storage_data() { return reinterpret_cast<_Ty*>(std::addressof(m_storage)); }
+			const _Ty* storage_data() const { return reinterpret_cast<const _Ty*>(std::addressof(m_storage)); }
+
+			typename std::aligned_storage<sizeof(_Ty) * ((0 < _InlineCapacity) ? _InlineCapacity : 1), alignof(_Ty)>::type m_storage;
+			bool m_is_in_use = false;
+		};
+	}
+
+	/* An allocator that satisfies requests for up to _InlineCapacity elements from a given (inline) storage buffer, when
+	that buffer isn't already in use, and from the heap otherwise. Copies of the allocator refer to the same buffer (and
+	compare equal). */
+	template<class _Ty, size_t _InlineCapacity>
+	class msev_inline_storage_allocator {
+	public:
+		typedef _Ty value_type;
+		typedef impl::msev_inline_storage<_Ty, _InlineCapacity> storage_type;
+		template<class _Ty2> struct rebind { typedef msev_inline_storage_allocator<_Ty2, _InlineCapacity> other; };
+		typedef std::false_type propagate_on_container_copy_assignment;
+		typedef std::false_type propagate_on_container_move_assignment;
+		typedef std::false_type propagate_on_container_swap;
+		typedef std::false_type is_always_equal;
+
+		msev_inline_storage_allocator() {}
+		explicit msev_inline_storage_allocator(storage_type* storage_ptr) : m_storage_ptr(storage_ptr) {}
+		/* An allocator rebound to a different element type doesn't use the inline storage. */
+		template<class _Ty2>
+		msev_inline_storage_allocator(const msev_inline_storage_allocator<_Ty2, _InlineCapacity>&) {}
+
+		_Ty* allocate(size_t n) {
+			if (m_storage_ptr && (n <= _InlineCapacity) && (!m_storage_ptr->m_is_in_use)) {
+				m_storage_ptr->m_is_in_use = true;
+				return m_storage_ptr->storage_data();
+			}
+			return std::allocator<_Ty>().allocate(n);
+		}
+		void deallocate(_Ty* p, size_t n) {
+			if (m_storage_ptr && (m_storage_ptr->storage_data() == p)) {
+				assert(m_storage_ptr->m_is_in_use);
+				m_storage_ptr->m_is_in_use = false;
+			}
+			else {
+				std::allocator<_Ty>().deallocate(p, n);
+			}
+		}
+		/* A (std::vector) copy of a container can't share the original's inline storage. */
+		msev_inline_storage_allocator select_on_container_copy_construction() const { return msev_inline_storage_allocator(); }
+
+		bool operator==(const msev_inline_storage_allocator& _Right_cref) const { return (m_storage_ptr == _Right_cref.m_storage_ptr); }
+		bool operator!=(const msev_inline_storage_allocator& _Right_cref) const { return !((*this) == _Right_cref); }
+
+	private:
+		storage_type* m_storage_ptr = nullptr;
+	};
+
+	/* small_vector<> is an msevector<> that stores up to _InlineCapacity elements within the object itself, only allocating
+	from the heap when the number of elements exceeds that. Since ipointers and "safe" iterators refer to elements by
+	index, they remain valid when the elements move between inline and heap storage. Note that, unlike with msevector<>,
+	moving or swapping small_vector<>s moves or swaps the individual elements rather than just the buffers, and that
+	small_vector<>s shouldn't be moved or swapped via references to their msevector<> base. */
+	template<class _Ty, size_t _InlineCapacity>
+	class small_vector : private impl::msev_inline_storage<_Ty, _InlineCapacity>, public msevector<_Ty, msev_inline_storage_allocator<_Ty, _InlineCapacity> > {
+	public:
+		typedef msevector<_Ty, msev_inline_storage_allocator<_Ty, _InlineCapacity> > base_class;
+		typedef small_vector<_Ty, _InlineCapacity> _Myt;
+		typedef impl::msev_inline_storage<_Ty, _InlineCapacity> storage_type;
+		typedef typename base_class::allocator_type allocator_type;
+		typedef typename base_class::size_type size_type;
+		static const size_t inline_capacity = _InlineCapacity;
+
+		small_vector() : base_class(allocator_type(static_cast<storage_type*>(this))) {
+			reserve_inline();
+		}
+		explicit small_vector(size_type _N, const _Ty& _V = _Ty()) : base_class(allocator_type(static_cast<storage_type*>(this))) {
+			reserve_inline();
+			base_class::assign(_N, _V);
+		}
+		small_vector(_XSTD initializer_list<_Ty> _Ilist) : base_class(allocator_type(static_cast<storage_type*>(this))) {
+			reserve_inline();
+			base_class::assign(_Ilist);
+		}
+		template<class _Iter, class = _mse_RequireInputIter<_Iter> >
+		small_vector(_Iter _First, _Iter _Last) : base_class(allocator_type(static_cast<storage_type*>(this))) {
+			reserve_inline();
+			base_class::assign(_First, _Last);
+		}
+		small_vector(const _Myt& _X) : base_class(allocator_type(static_cast<storage_type*>(this))) {
+			reserve_inline();
+			base_class::assign(_X.cbegin(), _X.cend());
+		}
+		small_vector(_Myt&& _X) : base_class(allocator_type(static_cast<storage_type*>(this))) {
+			reserve_inline();
+			base_class::assign(std::make_move_iterator(_X.begin()), std::make_move_iterator(_X.end()));
+		}
+		_Myt& operator=(const _Myt& _X) {
+			if (this != std::addressof(_X)) {
+				base_class::assign(_X.cbegin(), _X.cend());
+			}
+			return (*this);
+		}
+		_Myt& operator=(_Myt&& _X) {
+			if (this != std::addressof(_X)) {
+				base_class::assign(std::make_move_iterator(_X.begin()), std::make_move_iterator(_X.end()));
+			}
+			return (*this);
+		}
+		_Myt& operator=(_XSTD initializer_list<_Ty> _Ilist) {
+			base_class::assign(_Ilist);
+			return (*this);
+		}
+		void swap(_Myt& _X) {
+			_Myt tmp(std::move(_X));
+			_X = std::move(*this);
+			(*this) = std::move(tmp);
+		}
+
+		/* Returns whether the elements are currently stored inline (rather than on the heap). */
+		bool is_inline() const {
+			return ((0 < (*this).capacity()) && (static_cast<const storage_type&>(*this).storage_data() == base_class::data()));
+		}
+
+	private:
+		void reserve_inline() {
+			if (0 < _InlineCapacity) {
+				base_class::reserve(size_type(_InlineCapacity));
+			}
+		}
+	};
+
+	namespace impl {
+		/* A heap allocated msevector<> with a (non-atomic) reference count and a count of the containers "owning" it. */
+		template<class _MV>
+		struct msevector_keep_alive_block {
+			explicit msevector_keep_alive_block(_MV&& msevector_rref) : m_msevector(std::move(msevector_rref)) {}
+			_MV m_msevector;
+			size_t m_ref_count = 0;
+			size_t m_owner_count = 0;
+		};
+
+		/* A (lighter weight) substitute for std::shared_ptr<_MV> that uses a non-atomic reference count. */
+		template<class _MV>
+		class msevector_keep_alive_ptr {
+		public:
+			typedef msevector_keep_alive_block<_MV> block_type;
+
+			msevector_keep_alive_ptr() {}
+			explicit msevector_keep_alive_ptr(block_type* block_ptr) : m_block_ptr(block_ptr) { add_ref(); }
+			msevector_keep_alive_ptr(const msevector_keep_alive_ptr& src_cref) : m_block_ptr(src_cref.m_block_ptr) { add_ref(); }
+			msevector_keep_alive_ptr(msevector_keep_alive_ptr&& src) : m_block_ptr(src.m_block_ptr) { src.m_block_ptr = nullptr; }
+			~msevector_keep_alive_ptr() { release(); }
+			msevector_keep_alive_ptr& operator=(const msevector_keep_alive_ptr& _Right_cref) {
+				msevector_keep_alive_ptr(_Right_cref).swap(*this);
+				return (*this);
+			}
+			msevector_keep_alive_ptr& operator=(msevector_keep_alive_ptr&& _Right) {
+				msevector_keep_alive_ptr(std::move(_Right)).swap(*this);
+				return (*this);
+			}
+			void swap(msevector_keep_alive_ptr& _Other) { std::swap(m_block_ptr, _Other.m_block_ptr); }
+			void reset() { msevector_keep_alive_ptr().swap(*this); }
+
+			_MV* get() const { return m_block_ptr ? std::addressof(m_block_ptr->m_msevector) : nullptr; }
+			_MV& operator*() const { assert(m_block_ptr); return m_block_ptr->m_msevector; }
+			_MV* operator->() const { assert(m_block_ptr); return std::addressof(m_block_ptr->m_msevector); }
+			explicit operator bool() const { return (nullptr != m_block_ptr); }
+			block_type* block_ptr() const { return m_block_ptr; }
+
+		private:
+			void add_ref() {
+				if (m_block_ptr) { m_block_ptr->m_ref_count += 1; }
+			}
+			void release() {
+				if (m_block_ptr) {
+					assert(1 <= m_block_ptr->m_ref_count);
+					m_block_ptr->m_ref_count -= 1;
+					if (0 == m_block_ptr->m_ref_count) {
+						delete m_block_ptr;
+					}
+					m_block_ptr = nullptr;
+				}
+			}
+
+			block_type* m_block_ptr = nullptr;
+		};
+
+		/* msevector_holder<> is used by mstd::vector<> and ivector<> to hold their msevector<>. The msevector<> is stored
+		inline until an iterator (or other reference that needs to keep it alive) is requested, at which point it's moved
+		into a (reference counted) heap allocation. So vectors whose iterators are never used don't incur a separate heap
+		allocation. */
+		template<class _MV>
+		class msevector_holder {
+		public:
+			typedef msevector_keep_alive_ptr<_MV> keep_alive_ptr_type;
+
+			template<class... _Args>
+			explicit msevector_holder(_Args&&... _Val) : m_inline_msevector(std::forward<_Args>(_Val)...) {}
+			~msevector_holder() { release_block(); }
+
+			_MV& operator*() const { return (*m_msevector_ptr); }
+			_MV* operator->() const { return m_msevector_ptr; }
+			_MV* get() const { return m_msevector_ptr; }
+
+			/* Returns a reference counted pointer to the msevector<>, moving it to the heap if it isn't already there. */
+			keep_alive_ptr_type keep_alive_ptr() const {
+				if (!m_block_kaptr) {
+					m_block_kaptr = keep_alive_ptr_type(new typename keep_alive_ptr_type::block_type(std::move(m_inline_msevector)));
+					m_block_kaptr.block_ptr()->m_owner_count = 1;
+					m_msevector_ptr = m_block_kaptr.get();
+				}
+				return m_block_kaptr;
+			}
+
+			/* Used to implement mstd::vector<>'s "copy-on-write" mode. */
+			bool is_shared() const { return (m_block_kaptr) && (1 < m_block_kaptr.block_ptr()->m_owner_count); }
+			void share(const msevector_holder& src_cref) {
+				release_block();
+				m_block_kaptr = src_cref.keep_alive_ptr();
+				m_block_kaptr.block_ptr()->m_owner_count += 1;
+				m_msevector_ptr = m_block_kaptr.get();
+			}
+			/* Stops sharing the msevector<> with other holders, making a copy of it (inline) if it's shared. */
+			void unshare() {
+				if (is_shared()) {
+					m_inline_msevector = (*m_msevector_ptr);
+					release_block();
+				}
+			}
+			/* Stops sharing the msevector<> with other holders, replacing it with an empty one if it's shared. */
+			void unshare_and_clear() {
+				if (is_shared()) {
+					m_inline_msevector.clear();
+					release_block();
+				}
+			}
+
+		private:
+			msevector_holder(const msevector_holder&) = delete;
+			msevector_holder& operator=(const msevector_holder&) = delete;
+
+			void release_block() {
+				if (m_block_kaptr) {
+					assert(1 <= m_block_kaptr.block_ptr()->m_owner_count);
+					m_block_kaptr.block_ptr()->m_owner_count -= 1;
+					m_block_kaptr.reset();
+				}
+				m_msevector_ptr = std::addressof(m_inline_msevector);
+			}
+
+			mutable _MV m_inline_msevector;
+			mutable keep_alive_ptr_type m_block_kaptr;
+			mutable _MV* m_msevector_ptr = std::addressof(m_inline_msevector);
+		};
+	}
+
 }
 
 #undef MSE_THROW
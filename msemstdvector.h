@@ -10,6 +10,13 @@
 
 #include "msemsevector.h"
 
+#ifdef MSE_CUSTOM_THROW_DEFINITION
+#include <iostream>
+#define MSE_THROW(x) MSE_CUSTOM_THROW_DEFINITION(x)
+#else // MSE_CUSTOM_THROW_DEFINITION
+#define MSE_THROW(x) throw(x)
+#endif // MSE_CUSTOM_THROW_DEFINITION
+
 #ifdef MSE_SAFER_SUBSTITUTES_DISABLED
 #define MSE_MSTDVECTOR_DISABLED
 #endif /*MSE_SAFER_SUBSTITUTES_DISABLED*/
@@ -42,70 +49,115 @@ namespace mse {
 			typedef typename _MV::reference reference;
 			typedef typename _MV::const_reference const_reference;
 
-			const _MV& msevector() const { return (*m_shptr); }
-			_MV& msevector() { return (*m_shptr); }
-			operator const _MV() const { return msevector(); }
-			operator _MV() { return msevector(); }
-
-			explicit vector(const _A& _Al = _A()) : m_shptr(std::make_shared<_MV>(_Al)) {}
-			explicit vector(size_type _N) : m_shptr(std::make_shared<_MV>(_N)) {}
-			explicit vector(size_type _N, const _Ty& _V, const _A& _Al = _A()) : m_shptr(std::make_shared<_MV>(_N, _V, _Al)) {}
-			vector(_Myt&& _X) : m_shptr(std::make_shared<_MV>(std::move(_X.msevector()))) {}
-			vector(const _Myt& _X) : m_shptr(std::make_shared<_MV>(_X.msevector())) {}
-			vector(_MV&& _X) : m_shptr(std::make_shared<_MV>(std::move(_X))) {}
-			vector(const _MV& _X) : m_shptr(std::make_shared<_MV>(_X)) {}
-			vector(std::vector<_Ty>&& _X) : m_shptr(std::make_shared<_MV>(std::move(_X))) {}
-			vector(const std::vector<_Ty>& _X) : m_shptr(std::make_shared<_MV>(_X)) {}
+			/* (The msevector is moved to the heap (if it isn't already there) so that references to it remain valid.) */
+			const _MV& msevector() const { return (*(m_holder.keep_alive_ptr())); }
+			_MV& msevector() { cow_prepare_for_mutable_access(); return (*(m_holder.keep_alive_ptr())); }
+			operator const _MV() const { return (*m_holder); }
+			operator _MV() { return (*m_holder); }
+
+			explicit vector(const _A& _Al = _A()) : m_holder(_Al) {}
+			explicit vector(size_type _N) : m_holder(_N) {}
+			explicit vector(size_type _N, const _Ty& _V, const _A& _Al = _A()) : m_holder(_N, _V, _Al) {}
+			vector(_Myt&& _X) : m_holder(), m_copy_on_write(_X.m_copy_on_write) {
+				if (_X.m_holder.is_shared()) {
+					/* The contents are shared with other vectors, so we can't move them. */
+					m_holder.share(_X.m_holder);
+				}
+				else {
+					(*m_holder) = std::move(*(_X.m_holder));
+				}
+			}
+			vector(const _Myt& _X) : m_holder(), m_copy_on_write(_X.m_copy_on_write) {
+				if (_X.cow_is_shareable()) {
+					m_holder.share(_X.m_holder);
+				}
+				else {
+					(*m_holder) = (*(_X.m_holder));
+				}
+			}
+			vector(_MV&& _X) : m_holder(std::move(_X)) {}
+			vector(const _MV& _X) : m_holder(_X) {}
+			vector(std::vector<_Ty>&& _X) : m_holder(std::move(_X)) {}
+			vector(const std::vector<_Ty>& _X) : m_holder(_X) {}
 			typedef typename _MV::const_iterator _It;
-			vector(_It _F, _It _L, const _A& _Al = _A()) : m_shptr(std::make_shared<_MV>(_F, _L, _Al)) {}
-			vector(const _Ty* _F, const _Ty* _L, const _A& _Al = _A()) : m_shptr(std::make_shared<_MV>(_F, _L, _Al)) {}
+			vector(_It _F, _It _L, const _A& _Al = _A()) : m_holder(_F, _L, _Al) {}
+			vector(const _Ty* _F, const _Ty* _L, const _A& _Al = _A()) : m_holder(_F, _L, _Al) {}
 			template<class _Iter, class = typename std::enable_if<_mse_Is_iterator<_Iter>::value, void>::type>
-			vector(_Iter _First, _Iter _Last) : m_shptr(std::make_shared<_MV>(_First, _Last)) {}
+			vector(_Iter _First, _Iter _Last) : m_holder(_First, _Last) {}
 			template<class _Iter, class = typename std::enable_if<_mse_Is_iterator<_Iter>::value, void>::type>
-			vector(_Iter _First, _Iter _Last, const _A& _Al) : m_shptr(std::make_shared<_MV>(_First, _Last, _Al)) {}
-
-			_Myt& operator=(_MV&& _X) { m_shptr->operator=(std::move(_X)); return (*this); }
-			_Myt& operator=(const _MV& _X) { m_shptr->operator=(_X); return (*this); }
-			_Myt& operator=(_Myt&& _X) { m_shptr->operator=(std::move(_X.msevector())); return (*this); }
-			_Myt& operator=(const _Myt& _X) { m_shptr->operator=(_X.msevector()); return (*this); }
-			void reserve(size_type _Count) { m_shptr->reserve(_Count); }
-			void resize(size_type _N, const _Ty& _X = _Ty()) { m_shptr->resize(_N, _X); }
-			typename _MV::const_reference operator[](size_type _P) const { return m_shptr->operator[](_P); }
-			typename _MV::reference operator[](size_type _P) { return m_shptr->operator[](_P); }
-			void push_back(_Ty&& _X) { m_shptr->push_back(std::move(_X)); }
-			void push_back(const _Ty& _X) { m_shptr->push_back(_X); }
-			void pop_back() { m_shptr->pop_back(); }
-			void assign(_It _F, _It _L) { m_shptr->assign(_F, _L); }
-			void assign(size_type _N, const _Ty& _X = _Ty()) { m_shptr->assign(_N, _X); }
+			vector(_Iter _First, _Iter _Last, const _A& _Al) : m_holder(_First, _Last, _Al) {}
+
+			_Myt& operator=(_MV&& _X) { cow_prepare_for_overwrite(); m_holder->operator=(std::move(_X)); return (*this); }
+			_Myt& operator=(const _MV& _X) { cow_prepare_for_overwrite(); m_holder->operator=(_X); return (*this); }
+			_Myt& operator=(_Myt&& _X) {
+				if (&_X == this) { return (*this); }
+				cow_prepare_for_overwrite();
+				if (_X.m_holder.is_shared()) {
+					m_holder->operator=(*(_X.m_holder));
+				}
+				else {
+					m_holder->operator=(std::move(*(_X.m_holder)));
+				}
+				return (*this);
+			}
+			_Myt& operator=(const _Myt& _X) {
+				if (&_X == this) { return (*this); }
+				cow_prepare_for_overwrite();
+				m_holder->operator=(*(_X.m_holder));
+				return (*this);
+			}
+			void reserve(size_type _Count) { cow_prepare_for_mutation(); m_holder->reserve(_Count); }
+			void resize(size_type _N, const _Ty& _X = _Ty()) { cow_prepare_for_mutation(); m_holder->resize(_N, _X); }
+			typename _MV::const_reference operator[](size_type _P) const { return m_holder->operator[](_P); }
+			typename _MV::reference operator[](size_type _P) { cow_prepare_for_mutable_access(); return m_holder->operator[](_P); }
+			void push_back(_Ty&& _X) { cow_prepare_for_mutation(); m_holder->push_back(std::move(_X)); }
+			void push_back(const _Ty& _X) { cow_prepare_for_mutation(); m_holder->push_back(_X); }
+			void pop_back() { cow_prepare_for_mutation(); m_holder->pop_back(); }
+			void assign(_It _F, _It _L) { cow_prepare_for_overwrite(); m_holder->assign(_F, _L); }
+			void assign(size_type _N, const _Ty& _X = _Ty()) { cow_prepare_for_overwrite(); m_holder->assign(_N, _X); }
 			template<class ..._Valty>
-			void emplace_back(_Valty&& ..._Val) { m_shptr->emplace_back(std::forward<_Valty>(_Val)...); }
-			void clear() { m_shptr->clear(); }
-			void swap(_MV& _X) { m_shptr->swap(_X); }
-			void swap(_Myt& _X) { m_shptr->swap(_X.msevector()); }
-
-			vector(_XSTD initializer_list<typename _MV::value_type> _Ilist, const _A& _Al = _A()) : m_shptr(std::make_shared<_MV>(_Ilist, _Al)) {}
-			_Myt& operator=(_XSTD initializer_list<typename _MV::value_type> _Ilist) { m_shptr->operator=(_Ilist); return (*this); }
-			void assign(_XSTD initializer_list<typename _MV::value_type> _Ilist) { m_shptr->assign(_Ilist); }
-
-			size_type capacity() const _NOEXCEPT{ return m_shptr->capacity(); }
-			void shrink_to_fit() { m_shptr->shrink_to_fit(); }
-			size_type size() const _NOEXCEPT{ return m_shptr->size(); }
-			size_type max_size() const _NOEXCEPT{ return m_shptr->max_size(); }
-			bool empty() const _NOEXCEPT{ return m_shptr->empty(); }
-			_A get_allocator() const _NOEXCEPT{ return m_shptr->get_allocator(); }
-			typename _MV::const_reference at(size_type _Pos) const { return m_shptr->at(_Pos); }
-			typename _MV::reference at(size_type _Pos) { return m_shptr->at(_Pos); }
-			typename _MV::reference front() { return m_shptr->front(); }
-			typename _MV::const_reference front() const { return m_shptr->front(); }
-			typename _MV::reference back() { return m_shptr->back(); }
-			typename _MV::const_reference back() const { return m_shptr->back(); }
+			void emplace_back(_Valty&& ..._Val) { cow_prepare_for_mutation(); m_holder->emplace_back(std::forward<_Valty>(_Val)...); }
+			void clear() { cow_prepare_for_overwrite(); m_holder->clear(); }
+			void swap(_MV& _X) { cow_prepare_for_mutation(); m_holder->swap(_X); }
+			void swap(_Myt& _X) {
+				cow_prepare_for_mutation();
+				_X.cow_prepare_for_mutation();
+				m_holder->swap(*(_X.m_holder));
+			}
+
+			vector(_XSTD initializer_list<typename _MV::value_type> _Ilist, const _A& _Al = _A()) : m_holder(_Ilist, _Al) {}
+			_Myt& operator=(_XSTD initializer_list<typename _MV::value_type> _Ilist) { cow_prepare_for_overwrite(); m_holder->operator=(_Ilist); return (*this); }
+			void assign(_XSTD initializer_list<typename _MV::value_type> _Ilist) { cow_prepare_for_overwrite(); m_holder->assign(_Ilist); }
+
+			/* In "copy-on-write" mode, copies of the vector share its contents until one of them is modified (or a
+			non-const reference, pointer or iterator to an element is obtained from one of them). Copies of a vector in
+			copy-on-write mode are also in copy-on-write mode. */
+			void set_copy_on_write(bool copy_on_write) {
+				if (!copy_on_write) { cow_prepare_for_mutation(); }
+				m_copy_on_write = copy_on_write;
+			}
+			bool copy_on_write() const { return m_copy_on_write; }
+
+			size_type capacity() const _NOEXCEPT{ return m_holder->capacity(); }
+			void shrink_to_fit() { cow_prepare_for_mutation(); m_holder->shrink_to_fit(); }
+			size_type size() const _NOEXCEPT{ return m_holder->size(); }
+			size_type max_size() const _NOEXCEPT{ return m_holder->max_size(); }
+			bool empty() const _NOEXCEPT{ return m_holder->empty(); }
+			_A get_allocator() const _NOEXCEPT{ return m_holder->get_allocator(); }
+			typename _MV::const_reference at(size_type _Pos) const { return m_holder->at(_Pos); }
+			typename _MV::reference at(size_type _Pos) { cow_prepare_for_mutable_access(); return m_holder->at(_Pos); }
+			typename _MV::reference front() { cow_prepare_for_mutable_access(); return m_holder->front(); }
+			typename _MV::const_reference front() const { return m_holder->front(); }
+			typename _MV::reference back() { cow_prepare_for_mutable_access(); return m_holder->back(); }
+			typename _MV::const_reference back() const { return m_holder->back(); }
 
 			/* Try to avoid using these whenever possible. */
-			value_type *data() _NOEXCEPT {
-				return m_shptr->data();
+			value_type *data() {
+				cow_prepare_for_mutable_access();
+				return m_holder->data();
 			}
 			const value_type *data() const _NOEXCEPT {
-				return m_shptr->data();
+				return m_holder->data();
 			}
 
 
@@ -119,7 +171,7 @@ namespace mse {
 				typedef typename _MV::ss_const_iterator_type::reference reference;
 
 				const_iterator() {}
-				const_iterator(const const_iterator& src_cref) : m_msevector_cshptr(src_cref.m_msevector_cshptr) {
+				const_iterator(const const_iterator& src_cref) : m_msevector_kaptr(src_cref.m_msevector_kaptr) {
 					(*this) = src_cref;
 				}
 				~const_iterator() {}
@@ -166,11 +218,11 @@ namespace mse {
 				void set_to_const_item_pointer(const const_iterator& _Right_cref) { msevector_ss_const_iterator_type().set_to_const_item_pointer(_Right_cref.msevector_ss_const_iterator_type()); }
 				msev_size_t position() const { return msevector_ss_const_iterator_type().position(); }
 			private:
-				const_iterator(std::shared_ptr<_MV> msevector_shptr) : m_msevector_cshptr(msevector_shptr) {
-					m_ss_const_iterator = msevector_shptr->ss_cbegin();
+				const_iterator(const impl::msevector_keep_alive_ptr<_MV>& msevector_kaptr) : m_msevector_kaptr(msevector_kaptr) {
+					m_ss_const_iterator = msevector_kaptr->ss_cbegin();
 				}
-				std::shared_ptr<const _MV> m_msevector_cshptr;
-				/* m_ss_const_iterator needs to be declared after m_msevector_cshptr so that it's destructor will be called first. */
+				impl::msevector_keep_alive_ptr<_MV> m_msevector_kaptr;
+				/* m_ss_const_iterator needs to be declared after m_msevector_kaptr so that it's destructor will be called first. */
 				typename _MV::ss_const_iterator_type m_ss_const_iterator;
 				friend class /*_Myt*/vector<_Ty, _A>;
 				friend class iterator;
@@ -185,7 +237,7 @@ namespace mse {
 				typedef typename _MV::ss_iterator_type::reference reference;
 
 				iterator() {}
-				iterator(const iterator& src_cref) : m_msevector_shptr(src_cref.m_msevector_shptr) {
+				iterator(const iterator& src_cref) : m_msevector_kaptr(src_cref.m_msevector_kaptr) {
 					(*this) = src_cref;
 				}
 				~iterator() {}
@@ -194,8 +246,8 @@ namespace mse {
 				const typename _MV::ss_iterator_type& mvssi() const { return msevector_ss_iterator_type(); }
 				typename _MV::ss_iterator_type& mvssi() { return msevector_ss_iterator_type(); }
 				operator const_iterator() const {
-					const_iterator retval(m_msevector_shptr);
-					if (m_msevector_shptr) {
+					const_iterator retval(m_msevector_kaptr);
+					if (m_msevector_kaptr) {
 						retval.msevector_ss_const_iterator_type().set_to_beginning();
 						retval.msevector_ss_const_iterator_type().advance(msev_int(msevector_ss_iterator_type().position()));
 					}
@@ -240,63 +292,164 @@ namespace mse {
 				void set_to_item_pointer(const iterator& _Right_cref) { msevector_ss_iterator_type().set_to_item_pointer(_Right_cref.msevector_ss_iterator_type()); }
 				msev_size_t position() const { return msevector_ss_iterator_type().position(); }
 			private:
-				std::shared_ptr<_MV> m_msevector_shptr;
-				/* m_ss_iterator needs to be declared after m_msevector_shptr so that it's destructor will be called first. */
+				impl::msevector_keep_alive_ptr<_MV> m_msevector_kaptr;
+				/* m_ss_iterator needs to be declared after m_msevector_kaptr so that it's destructor will be called first. */
 				typename _MV::ss_iterator_type m_ss_iterator;
 				friend class /*_Myt*/vector<_Ty, _A>;
 			};
 
+			/* gen_iterator and gen_const_iterator are lighter weight alternatives to iterator and const_iterator. Rather than
+			a position in the vector, they hold a (raw) pointer to the element, along with the vector's "structure generation"
+			at the time they were obtained. Any operation that could change the vector's size or relocate its elements
+			increments the generation, so checking the validity of the iterator when it's dereferenced just requires
+			comparing the two generations. Like iterator and const_iterator, they keep the vector's contents alive. Unlike
+			them, they do not follow their item when elements are inserted or removed. Such operations just render them
+			invalid, and any subsequent attempt to dereference them will result in an exception. */
+			template<class _TElementPointer, class _TElementReference, class _TIteratorBase>
+			class gen_iterator_type : public _TIteratorBase {
+			public:
+				typedef std::random_access_iterator_tag iterator_category;
+				typedef typename _MV::value_type value_type;
+				typedef typename _MV::difference_type difference_type;
+				typedef typename _MV::difference_type distance_type;	// retained
+				typedef _TElementPointer pointer;
+				typedef _TElementReference reference;
+
+				gen_iterator_type() {}
+				/* Allows gen_iterator to be converted to gen_const_iterator. */
+				template<class _TElementPointer2, class _TElementReference2, class _TIteratorBase2
+					, class = typename std::enable_if<std::is_convertible<_TElementPointer2, _TElementPointer>::value, void>::type>
+				gen_iterator_type(const gen_iterator_type<_TElementPointer2, _TElementReference2, _TIteratorBase2>& src_cref)
+					: m_msevector_kaptr(src_cref.m_msevector_kaptr), m_ptr(src_cref.m_ptr), m_begin_ptr(src_cref.m_begin_ptr)
+					, m_end_ptr(src_cref.m_end_ptr), m_generation(src_cref.m_generation) {}
+
+				/* Returns false if the vector's size may have changed, or its elements may have been relocated, since the
+				iterator was obtained. (An end marker may be valid, but still not dereferenceable.) */
+				bool is_valid() const { return (m_msevector_kaptr) && (m_generation == m_msevector_kaptr->structure_generation()); }
+				bool points_to_an_item() const { return (m_end_ptr != m_ptr) && is_valid(); }
+				bool points_to_end_marker() const { return (m_end_ptr == m_ptr); }
+				bool points_to_beginning() const { return (m_begin_ptr == m_ptr); }
+
+				reference operator*() const { return (*checked_ptr()); }
+				reference item() const { return operator*(); }
+				pointer operator->() const { return checked_ptr(); }
+				reference operator[](difference_type _Off) const { return (*((*this) + _Off)); }
+				gen_iterator_type& operator +=(difference_type n) {
+					if ((0 <= n) ? (m_end_ptr - m_ptr < n) : (m_begin_ptr - m_ptr > n)) {
+						MSE_THROW(msevector_range_error("index out of range - gen_iterator_type& operator +=(difference_type n) - gen_iterator_type - mse::mstd::vector"));
+					}
+					m_ptr += n;
+					return (*this);
+				}
+				gen_iterator_type& operator -=(difference_type n) { return ((*this) += (-n)); }
+				gen_iterator_type& operator ++() { return ((*this) += 1); }
+				gen_iterator_type operator++(int) { gen_iterator_type _Tmp = *this; ++*this; return (_Tmp); }
+				gen_iterator_type& operator --() { return ((*this) -= 1); }
+				gen_iterator_type operator--(int) { gen_iterator_type _Tmp = *this; --*this; return (_Tmp); }
+				gen_iterator_type operator+(difference_type n) const { auto retval = (*this); retval += n; return retval; }
+				gen_iterator_type operator-(difference_type n) const { return ((*this) + (-n)); }
+				difference_type operator-(const gen_iterator_type& _Right_cref) const {
+					same_vector_check(_Right_cref);
+					return (m_ptr - _Right_cref.m_ptr);
+				}
+				bool operator==(const gen_iterator_type& _Right_cref) const { return (m_ptr == _Right_cref.m_ptr) && (m_msevector_kaptr.get() == _Right_cref.m_msevector_kaptr.get()); }
+				bool operator!=(const gen_iterator_type& _Right_cref) const { return (!(_Right_cref == (*this))); }
+				bool operator<(const gen_iterator_type& _Right) const { return (0 > ((*this) - _Right)); }
+				bool operator<=(const gen_iterator_type& _Right) const { return (0 >= ((*this) - _Right)); }
+				bool operator>(const gen_iterator_type& _Right) const { return (0 < ((*this) - _Right)); }
+				bool operator>=(const gen_iterator_type& _Right) const { return (0 <= ((*this) - _Right)); }
+				msev_size_t position() const { return msev_size_t(m_ptr - m_begin_ptr); }
+
+			private:
+				pointer checked_ptr() const {
+					/* A default constructed iterator is (also) an end marker, so the vector is only accessed if the iterator
+					was obtained from one. */
+					if ((m_end_ptr == m_ptr) || (m_generation != m_msevector_kaptr->structure_generation())) {
+						MSE_THROW(msevector_range_error("attempt to use invalid iterator - pointer checked_ptr() const - gen_iterator_type - mse::mstd::vector"));
+					}
+					return m_ptr;
+				}
+				void same_vector_check(const gen_iterator_type& _Right_cref) const {
+					if (m_msevector_kaptr.get() != _Right_cref.m_msevector_kaptr.get()) {
+						MSE_THROW(msevector_range_error("invalid argument - void same_vector_check(const gen_iterator_type& _Right_cref) const - gen_iterator_type - mse::mstd::vector"));
+					}
+				}
+
+				impl::msevector_keep_alive_ptr<_MV> m_msevector_kaptr;
+				pointer m_ptr = nullptr;
+				pointer m_begin_ptr = nullptr;
+				pointer m_end_ptr = nullptr;
+				size_t m_generation = 0;
+				template<class _TElementPointer2, class _TElementReference2, class _TIteratorBase2> friend class gen_iterator_type;
+				friend class /*_Myt*/vector<_Ty, _A>;
+			};
+			typedef gen_iterator_type<typename _MV::pointer, typename _MV::reference, typename _MV::random_access_iterator_base> gen_iterator;
+			typedef gen_iterator_type<typename _MV::const_pointer, typename _MV::const_reference, typename _MV::random_access_const_iterator_base> gen_const_iterator;
+
 			iterator begin()
 			{	// return iterator for beginning of mutable sequence
-				iterator retval; retval.m_msevector_shptr = this->m_shptr;
-				(retval.m_ss_iterator) = m_shptr->ss_begin();
+				cow_prepare_for_mutable_access();
+				iterator retval; retval.m_msevector_kaptr = m_holder.keep_alive_ptr();
+				(retval.m_ss_iterator) = m_holder->ss_begin();
 				return retval;
 			}
 
 			const_iterator begin() const
 			{	// return iterator for beginning of nonmutable sequence
-				const_iterator retval; retval.m_msevector_cshptr = this->m_shptr;
-				(retval.m_ss_const_iterator) = m_shptr->ss_begin();
+				const_iterator retval; retval.m_msevector_kaptr = m_holder.keep_alive_ptr();
+				(retval.m_ss_const_iterator) = m_holder->ss_begin();
 				return retval;
 			}
 
 			iterator end() {	// return iterator for end of mutable sequence
-				iterator retval; retval.m_msevector_shptr = this->m_shptr;
-				(retval.m_ss_iterator) = m_shptr->ss_end();
+				cow_prepare_for_mutable_access();
+				iterator retval; retval.m_msevector_kaptr = m_holder.keep_alive_ptr();
+				(retval.m_ss_iterator) = m_holder->ss_end();
 				return retval;
 			}
 			const_iterator end() const {	// return iterator for end of nonmutable sequence
-				const_iterator retval; retval.m_msevector_cshptr = this->m_shptr;
-				(retval.m_ss_const_iterator) = m_shptr->ss_end();
+				const_iterator retval; retval.m_msevector_kaptr = m_holder.keep_alive_ptr();
+				(retval.m_ss_const_iterator) = m_holder->ss_end();
 				return retval;
 			}
 			const_iterator cbegin() const {	// return iterator for beginning of nonmutable sequence
-				const_iterator retval; retval.m_msevector_cshptr = this->m_shptr;
-				(retval.m_ss_const_iterator) = m_shptr->ss_cbegin();
+				const_iterator retval; retval.m_msevector_kaptr = m_holder.keep_alive_ptr();
+				(retval.m_ss_const_iterator) = m_holder->ss_cbegin();
 				return retval;
 			}
 			const_iterator cend() const {	// return iterator for end of nonmutable sequence
-				const_iterator retval; retval.m_msevector_cshptr = this->m_shptr;
-				(retval.m_ss_const_iterator) = m_shptr->ss_cend();
+				const_iterator retval; retval.m_msevector_kaptr = m_holder.keep_alive_ptr();
+				(retval.m_ss_const_iterator) = m_holder->ss_cend();
 				return retval;
 			}
 
+			gen_iterator gen_begin() { cow_prepare_for_mutable_access(); return make_gen_iterator<gen_iterator>(false); }
+			gen_const_iterator gen_begin() const { return make_gen_iterator<gen_const_iterator>(false); }
+			gen_iterator gen_end() { cow_prepare_for_mutable_access(); return make_gen_iterator<gen_iterator>(true); }
+			gen_const_iterator gen_end() const { return make_gen_iterator<gen_const_iterator>(true); }
+			gen_const_iterator gen_cbegin() const { return make_gen_iterator<gen_const_iterator>(false); }
+			gen_const_iterator gen_cend() const { return make_gen_iterator<gen_const_iterator>(true); }
+
 
 			vector(const const_iterator &start, const const_iterator &end, const _A& _Al = _A())
-				: m_shptr(std::make_shared<_MV>(start.msevector_ss_const_iterator_type(), end.msevector_ss_const_iterator_type(), _Al)) {}
+				: m_holder(start.msevector_ss_const_iterator_type(), end.msevector_ss_const_iterator_type(), _Al) {}
 			void assign(const const_iterator &start, const const_iterator &end) {
-				m_shptr->assign(start.msevector_ss_const_iterator_type(), end.msevector_ss_const_iterator_type());
+				cow_prepare_for_overwrite();
+				m_holder->assign(start.msevector_ss_const_iterator_type(), end.msevector_ss_const_iterator_type());
 			}
 			void assign_inclusive(const const_iterator &first, const const_iterator &last) {
-				m_shptr->assign_inclusive(first.msevector_ss_const_iterator_type(), last.msevector_ss_const_iterator_type());
+				cow_prepare_for_overwrite();
+				m_holder->assign_inclusive(first.msevector_ss_const_iterator_type(), last.msevector_ss_const_iterator_type());
 			}
 			iterator insert_before(const const_iterator &pos, size_type _M, const _Ty& _X) {
-				auto res = m_shptr->insert_before(pos.msevector_ss_const_iterator_type(), _M, _X);
+				const auto pos_ssci = cow_rebased(pos, prepare_for_iterator_returning_mutation());
+				auto res = m_holder->insert_before(pos_ssci, _M, _X);
 				iterator retval = begin(); retval.msevector_ss_iterator_type() = res;
 				return retval;
 			}
 			iterator insert_before(const const_iterator &pos, _Ty&& _X) {
-				auto res = m_shptr->insert_before(pos.msevector_ss_const_iterator_type(), std::move(_X));
+				const auto pos_ssci = cow_rebased(pos, prepare_for_iterator_returning_mutation());
+				auto res = m_holder->insert_before(pos_ssci, std::move(_X));
 				iterator retval = begin(); retval.msevector_ss_iterator_type() = res;
 				return retval;
 			}
@@ -305,7 +458,8 @@ namespace mse {
 				//>typename std::enable_if<_mse_Is_iterator<_Iter>::value, typename base_class::iterator>::type
 				, class = _mse_RequireInputIter<_Iter> >
 			iterator insert_before(const const_iterator &pos, const _Iter &start, const _Iter &end) {
-				auto res = m_shptr->insert_before(pos.msevector_ss_const_iterator_type(), start, end);
+				const auto pos_ssci = cow_rebased(pos, prepare_for_iterator_returning_mutation());
+				auto res = m_holder->insert_before(pos_ssci, start, end);
 				iterator retval = begin(); retval.msevector_ss_iterator_type() = res;
 				return retval;
 			}
@@ -317,18 +471,22 @@ namespace mse {
 				return insert_before(pos, first, end);
 			}
 			iterator insert_before(const const_iterator &pos, _XSTD initializer_list<typename _MV::value_type> _Ilist) {	// insert initializer_list
-				auto res = m_shptr->insert_before(pos.msevector_ss_const_iterator_type(), _Ilist);
+				const auto pos_ssci = cow_rebased(pos, prepare_for_iterator_returning_mutation());
+				auto res = m_holder->insert_before(pos_ssci, _Ilist);
 				iterator retval = begin(); retval.msevector_ss_iterator_type() = res;
 				return retval;
 			}
 			void insert_before(msev_size_t pos, const _Ty& _X = _Ty()) {
-				m_shptr->insert_before(pos, _X);
+				cow_prepare_for_mutation();
+				m_holder->insert_before(pos, _X);
 			}
 			void insert_before(msev_size_t pos, size_type _M, const _Ty& _X) {
-				m_shptr->insert_before(pos, _M, _X);
+				cow_prepare_for_mutation();
+				m_holder->insert_before(pos, _M, _X);
 			}
 			void insert_before(msev_size_t pos, _XSTD initializer_list<typename _MV::value_type> _Ilist) {	// insert initializer_list
-				m_shptr->insert_before(pos, _Ilist);
+				cow_prepare_for_mutation();
+				m_holder->insert_before(pos, _Ilist);
 			}
 			/* These insert() functions are just aliases for their corresponding insert_before() functions. */
 			iterator insert(const const_iterator &pos, size_type _M, const _Ty& _X) { return insert_before(pos, _M, _X); }
@@ -342,17 +500,22 @@ namespace mse {
 			iterator insert(const const_iterator &pos, _XSTD initializer_list<typename _MV::value_type> _Ilist) { return insert_before(pos, _Ilist); }
 			template<class ..._Valty>
 			iterator emplace(const const_iterator &pos, _Valty&& ..._Val) {
-				auto res = m_shptr->emplace(pos.msevector_ss_const_iterator_type(), std::forward<_Valty>(_Val)...);
+				const auto pos_ssci = cow_rebased(pos, prepare_for_iterator_returning_mutation());
+				auto res = m_holder->emplace(pos_ssci, std::forward<_Valty>(_Val)...);
 				iterator retval = begin(); retval.msevector_ss_iterator_type() = res;
 				return retval;
 			}
 			iterator erase(const const_iterator &pos) {
-				auto res = m_shptr->erase(pos.msevector_ss_const_iterator_type());
+				const auto pos_ssci = cow_rebased(pos, prepare_for_iterator_returning_mutation());
+				auto res = m_holder->erase(pos_ssci);
 				iterator retval = begin(); retval.msevector_ss_iterator_type() = res;
 				return retval;
 			}
 			iterator erase(const const_iterator &start, const const_iterator &end) {
-				auto res = m_shptr->erase(start.msevector_ss_const_iterator_type(), end.msevector_ss_const_iterator_type());
+				const auto prior_msevector_cptr = prepare_for_iterator_returning_mutation();
+				const auto start_ssci = cow_rebased(start, prior_msevector_cptr);
+				const auto end_ssci = cow_rebased(end, prior_msevector_cptr);
+				auto res = m_holder->erase(start_ssci, end_ssci);
 				iterator retval = begin(); retval.msevector_ss_iterator_type() = res;
 				return retval;
 			}
@@ -361,14 +524,71 @@ namespace mse {
 				return erase_inclusive(first, end);
 			}
 			bool operator==(const _Myt& _Right) const {	// test for vector equality
-				return ((*(_Right.m_shptr)) == (*m_shptr));
+				return ((*(_Right.m_holder)) == (*m_holder));
 			}
 			bool operator<(const _Myt& _Right) const {	// test if _Left < _Right for vectors
-				return ((*m_shptr) < (*(_Right.m_shptr)));
+				return ((*m_holder) < (*(_Right.m_holder)));
 			}
 
 		private:
-			std::shared_ptr<_MV> m_shptr;
+			bool cow_is_shareable() const { return m_copy_on_write && m_cow_shareable; }
+			/* If the contents are shared with other vectors, this gives the vector its own copy. Returns (a pointer to)
+			the msevector the vector was using before. */
+			const _MV* cow_prepare_for_mutation() {
+				const _MV* retval = m_holder.get();
+				m_holder.unshare();
+				return retval;
+			}
+			/* Like cow_prepare_for_mutation(), but for operations that replace all the contents, so there's no need to
+			copy the shared contents. */
+			void cow_prepare_for_overwrite() {
+				m_holder.unshare_and_clear();
+			}
+			/* Once a non-const reference (or iterator) to an element has been handed out, it could be used to modify the
+			contents at any time, so the contents can no longer be shared with copies. */
+			void cow_prepare_for_mutable_access() {
+				if (m_copy_on_write) {
+					m_holder.unshare();
+					m_cow_shareable = false;
+				}
+			}
+			/* Operations that return an iterator first move the msevector to the heap (if it isn't already there), since
+			the iterator is going to need to keep it alive. (Moving it afterwards would invalidate the iterator.) Returns
+			(a pointer to) the msevector the vector was using before. */
+			const _MV* prepare_for_iterator_returning_mutation() {
+				const _MV* retval = m_holder.get();
+				m_holder.unshare();
+				cow_prepare_for_mutable_access();
+				m_holder.keep_alive_ptr();
+				return retval;
+			}
+			/* If the given iterator refers to the (shared) contents this vector was using before it got its own copy,
+			this returns an iterator to the same position in the copy. */
+			typename _MV::ss_const_iterator_type cow_rebased(const const_iterator& iter, const _MV* prior_msevector_cptr) const {
+				if ((prior_msevector_cptr != m_holder.get()) && (iter.m_msevector_kaptr.get() == prior_msevector_cptr)) {
+					auto retval = m_holder->ss_cbegin();
+					retval.advance(msev_int(iter.position()));
+					return retval;
+				}
+				return iter.msevector_ss_const_iterator_type();
+			}
+
+			template<class _TGenIterator>
+			_TGenIterator make_gen_iterator(bool end_marker) const {
+				_TGenIterator retval;
+				retval.m_msevector_kaptr = m_holder.keep_alive_ptr();
+				_MV& msevector_ref = (*(retval.m_msevector_kaptr));
+				retval.m_begin_ptr = msevector_ref.data();
+				retval.m_end_ptr = retval.m_begin_ptr + msevector_ref.size();
+				retval.m_ptr = end_marker ? retval.m_end_ptr : retval.m_begin_ptr;
+				retval.m_generation = msevector_ref.structure_generation();
+				return retval;
+			}
+
+			/* The msevector is stored inline until an iterator (that might need to keep it alive) is requested. */
+			impl::msevector_holder<_MV> m_holder;
+			bool m_copy_on_write = false;
+			bool m_cow_shareable = true;
 		};
 
 		template<class _Ty, class _Alloc> inline bool operator!=(const vector<_Ty, _Alloc>& _Left,
@@ -393,4 +613,7 @@ namespace mse {
 #endif /*MSE_MSTDVECTOR_DISABLED*/
 	}
 }
+
+#undef MSE_THROW
+
 #endif /*ndef MSEMSTDVECTOR_H*/
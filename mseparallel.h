@@ -0,0 +1,417 @@
+
+// Copyright (c) 2015 Noah Lopez
+// Use, modification, and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#ifndef MSEPARALLEL_H_
+#define MSEPARALLEL_H_
+
+#include <thread>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+#ifdef MSE_CUSTOM_THROW_DEFINITION
+#include <iostream>
+#define MSE_THROW(x) MSE_CUSTOM_THROW_DEFINITION(x)
+#else // MSE_CUSTOM_THROW_DEFINITION
+#define MSE_THROW(x) throw(x)
+#endif // MSE_CUSTOM_THROW_DEFINITION
+
+#ifndef MSE_PARALLEL_DEFAULT_MIN_CHUNK_SIZE
+/* Containers (or the remainder of a container) smaller than this many elements are not split any further. */
+#define MSE_PARALLEL_DEFAULT_MIN_CHUNK_SIZE 2048
+#endif // !MSE_PARALLEL_DEFAULT_MIN_CHUNK_SIZE
+
+namespace mse {
+
+	class parallel_range_error : public std::range_error { public:
+		using std::range_error::range_error;
+	};
+
+	namespace parallel {
+
+		/* A simple fixed size pool of worker threads. The parallel algorithms below use default_pool() unless you
+		pass them a pool explicitly. */
+		class thread_pool {
+		public:
+			typedef size_t size_type;
+
+			explicit thread_pool(size_type num_threads = default_num_threads()) {
+				if (1 > num_threads) { num_threads = 1; }
+				m_threads.reserve(num_threads);
+				for (size_type i = 0; i < num_threads; i += 1) {
+					m_threads.emplace_back([this]() { (*this).worker_loop(); });
+				}
+			}
+			~thread_pool() {
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_stopping = true;
+				}
+				m_cv.notify_all();
+				for (auto& thread_ref : m_threads) {
+					thread_ref.join();
+				}
+			}
+
+			size_type num_threads() const { return m_threads.size(); }
+
+			template<class _TFunction>
+			auto submit(_TFunction&& function) -> std::future<decltype(function())> {
+				typedef decltype(function()) result_t;
+				auto task_shptr = std::make_shared<std::packaged_task<result_t()>>(std::forward<_TFunction>(function));
+				auto retval = task_shptr->get_future();
+				post([task_shptr]() { (*task_shptr)(); });
+				return retval;
+			}
+
+			/* Calls function(chunk_index) for each chunk_index in [0, num_chunks) and returns when all calls have
+			completed. The calling thread processes chunks too, so it is safe to call this from within a task that is
+			itself running on the pool. If any call throws, the first exception is rethrown here (after all the other
+			chunks have finished). */
+			template<class _TFunction>
+			void run_chunks(size_type num_chunks, const _TFunction& function) {
+				if (0 == num_chunks) { return; }
+				if (1 == num_chunks) { function(size_type(0)); return; }
+
+				auto state_shptr = std::make_shared<chunk_run_state>(num_chunks);
+				/* Helper tasks only access function while there are unclaimed chunks, and we don't return before every
+				claimed chunk has completed, so the reference to function can't dangle. */
+				std::function<void(size_type)> chunk_func = [&function](size_type chunk_index) { function(chunk_index); };
+				auto helper = [state_shptr, &chunk_func]() { state_shptr->process_chunks(chunk_func); };
+				const auto num_helpers = std::min(num_threads(), num_chunks - 1);
+				for (size_type i = 0; i < num_helpers; i += 1) {
+					post(helper);
+				}
+				state_shptr->process_chunks(chunk_func);
+				state_shptr->wait_for_completion();
+				if (state_shptr->m_first_exception) {
+					std::rethrow_exception(state_shptr->m_first_exception);
+				}
+			}
+
+			static size_type default_num_threads() {
+				const size_type hardware_concurrency = std::thread::hardware_concurrency();
+				return (1 <= hardware_concurrency) ? hardware_concurrency : 1;
+			}
+			static thread_pool& default_pool() {
+				static thread_pool s_default_pool;
+				return s_default_pool;
+			}
+
+		private:
+			thread_pool(const thread_pool&) = delete;
+			thread_pool& operator=(const thread_pool&) = delete;
+
+			class chunk_run_state {
+			public:
+				chunk_run_state(size_type num_chunks) : m_num_chunks(num_chunks) {}
+				void process_chunks(const std::function<void(size_type)>& chunk_func) {
+					while (true) {
+						const auto chunk_index = m_next_chunk_index.fetch_add(1);
+						if (m_num_chunks <= chunk_index) { break; }
+						try {
+							chunk_func(chunk_index);
+						}
+						catch (...) {
+							std::lock_guard<std::mutex> lock(m_mutex);
+							if (!m_first_exception) { m_first_exception = std::current_exception(); }
+						}
+						if (m_num_chunks == (m_num_completed_chunks.fetch_add(1) + 1)) {
+							std::lock_guard<std::mutex> lock(m_mutex);
+							m_cv.notify_all();
+						}
+					}
+				}
+				void wait_for_completion() {
+					std::unique_lock<std::mutex> lock(m_mutex);
+					m_cv.wait(lock, [this]() { return m_num_chunks <= m_num_completed_chunks.load(); });
+				}
+
+				const size_type m_num_chunks;
+				std::atomic<size_type> m_next_chunk_index{ 0 };
+				std::atomic<size_type> m_num_completed_chunks{ 0 };
+				std::mutex m_mutex;
+				std::condition_variable m_cv;
+				std::exception_ptr m_first_exception;
+			};
+
+			void post(std::function<void()> task) {
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_tasks.push_back(std::move(task));
+				}
+				m_cv.notify_one();
+			}
+			void worker_loop() {
+				while (true) {
+					std::function<void()> task;
+					{
+						std::unique_lock<std::mutex> lock(m_mutex);
+						m_cv.wait(lock, [this]() { return m_stopping || (!m_tasks.empty()); });
+						if (m_tasks.empty()) { return; }
+						task = std::move(m_tasks.front());
+						m_tasks.pop_front();
+					}
+					task();
+				}
+			}
+
+			std::vector<std::thread> m_threads;
+			std::deque<std::function<void()>> m_tasks;
+			std::mutex m_mutex;
+			std::condition_variable m_cv;
+			bool m_stopping = false;
+		};
+
+		namespace impl {
+			/* A contiguous, disjoint section of a container's elements. The section's bounds are checked against the
+			container (once) when the section is constructed, so element access within the section doesn't need to be
+			checked again. Sections are only created (and used) for the duration of a parallel algorithm call, during
+			which the container must not be resized. */
+			template<class _TElement>
+			class TCheckedChunk {
+			public:
+				typedef size_t size_type;
+
+				template<class _TContainer>
+				TCheckedChunk(_TContainer& container, size_type first_index, size_type last_index) {
+					const size_type container_size = container.size();
+					if ((last_index < first_index) || (container_size < last_index)) {
+						MSE_THROW(parallel_range_error("out of bounds section - TCheckedChunk(_TContainer& container, size_type first_index, size_type last_index) - mse::parallel::impl::TCheckedChunk"));
+					}
+					m_begin = (first_index < last_index) ? (container.data() + first_index) : nullptr;
+					m_size = last_index - first_index;
+				}
+
+				_TElement& operator[](size_type index) const {
+					assert(index < m_size);
+					return m_begin[index];
+				}
+				size_type size() const { return m_size; }
+				_TElement* begin() const { return m_begin; }
+				_TElement* end() const { return m_begin + m_size; }
+
+			private:
+				_TElement* m_begin = nullptr;
+				size_type m_size = 0;
+			};
+
+			/* Used to keep the overloads that use the default pool from matching calls that pass a pool explicitly. */
+			template<class _Ty>
+			using enable_if_not_pool_t = typename std::enable_if<!std::is_same<thread_pool, typename std::remove_cv<_Ty>::type>::value>::type;
+
+			template<class _TContainer>
+			using element_t = typename std::remove_reference<decltype(*(std::declval<_TContainer&>().data()))>::type;
+
+			inline size_t num_chunks_for(const thread_pool& pool, size_t num_elements, size_t min_chunk_size = MSE_PARALLEL_DEFAULT_MIN_CHUNK_SIZE) {
+				if (1 > min_chunk_size) { min_chunk_size = 1; }
+				/* A few chunks per thread so that uneven per element costs still get balanced. */
+				const size_t max_num_chunks = 4 * pool.num_threads();
+				const size_t num_chunks = num_elements / min_chunk_size;
+				return std::max(size_t(1), std::min(num_chunks, max_num_chunks));
+			}
+			inline size_t chunk_first_index(size_t num_elements, size_t num_chunks, size_t chunk_index) {
+				return (num_elements / num_chunks) * chunk_index + std::min(chunk_index, num_elements % num_chunks);
+			}
+
+			/* Calls function(chunk) for each of num_chunks disjoint checked sections that together cover the container. */
+			template<class _TContainer, class _TFunction>
+			void for_each_chunk(thread_pool& pool, _TContainer& container, size_t num_chunks, const _TFunction& function) {
+				const size_t num_elements = container.size();
+				pool.run_chunks(num_chunks, [&](size_t chunk_index) {
+					const TCheckedChunk<element_t<_TContainer>> chunk(container, chunk_first_index(num_elements, num_chunks, chunk_index)
+						, chunk_first_index(num_elements, num_chunks, chunk_index + 1));
+					function(chunk, chunk_index);
+				});
+			}
+		}
+
+		template<class _TContainer, class _TFunction>
+		void for_each(thread_pool& pool, _TContainer& container, _TFunction function) {
+			const auto num_chunks = impl::num_chunks_for(pool, container.size());
+			impl::for_each_chunk(pool, container, num_chunks, [&function](const impl::TCheckedChunk<impl::element_t<_TContainer>>& chunk, size_t) {
+				for (auto& element_ref : chunk) {
+					function(element_ref);
+				}
+			});
+		}
+		template<class _TContainer, class _TFunction, class = impl::enable_if_not_pool_t<_TContainer>>
+		void for_each(_TContainer& container, _TFunction function) {
+			mse::parallel::for_each(thread_pool::default_pool(), container, std::move(function));
+		}
+
+		/* dest must have at least as many elements as src. src and dest may be the same container. */
+		template<class _TSrcContainer, class _TDestContainer, class _TFunction>
+		void transform(thread_pool& pool, const _TSrcContainer& src, _TDestContainer& dest, _TFunction function) {
+			const size_t num_elements = src.size();
+			if (dest.size() < num_elements) {
+				MSE_THROW(parallel_range_error("destination is smaller than source - void transform(thread_pool& pool, const _TSrcContainer& src, _TDestContainer& dest, _TFunction function) - mse::parallel"));
+			}
+			const auto num_chunks = impl::num_chunks_for(pool, num_elements);
+			impl::for_each_chunk(pool, src, num_chunks, [&](const impl::TCheckedChunk<impl::element_t<const _TSrcContainer>>& src_chunk, size_t chunk_index) {
+				const auto first_index = impl::chunk_first_index(num_elements, num_chunks, chunk_index);
+				const impl::TCheckedChunk<impl::element_t<_TDestContainer>> dest_chunk(dest, first_index, first_index + src_chunk.size());
+				std::transform(src_chunk.begin(), src_chunk.end(), dest_chunk.begin(), function);
+			});
+		}
+		template<class _TSrcContainer, class _TDestContainer, class _TFunction, class = impl::enable_if_not_pool_t<_TSrcContainer>>
+		void transform(const _TSrcContainer& src, _TDestContainer& dest, _TFunction function) {
+			mse::parallel::transform(thread_pool::default_pool(), src, dest, std::move(function));
+		}
+
+		/* binary_op is assumed to be associative. The partial results of the chunks are combined in order, so
+		binary_op need not be commutative. */
+		template<class _TContainer, class _Ty, class _TBinaryOp>
+		_Ty reduce(thread_pool& pool, const _TContainer& container, _Ty init, _TBinaryOp binary_op) {
+			const auto num_chunks = impl::num_chunks_for(pool, container.size());
+			std::vector<std::unique_ptr<_Ty>> partial_results(num_chunks);
+			impl::for_each_chunk(pool, container, num_chunks, [&](const impl::TCheckedChunk<impl::element_t<const _TContainer>>& chunk, size_t chunk_index) {
+				if (1 <= chunk.size()) {
+					_Ty partial_result = chunk[0];
+					for (size_t i = 1; i < chunk.size(); i += 1) {
+						partial_result = binary_op(std::move(partial_result), chunk[i]);
+					}
+					partial_results[chunk_index] = std::unique_ptr<_Ty>(new _Ty(std::move(partial_result)));
+				}
+			});
+			for (auto& partial_result_uqptr : partial_results) {
+				if (partial_result_uqptr) {
+					init = binary_op(std::move(init), std::move(*partial_result_uqptr));
+				}
+			}
+			return init;
+		}
+		template<class _TContainer, class _Ty>
+		_Ty reduce(thread_pool& pool, const _TContainer& container, _Ty init) {
+			return mse::parallel::reduce(pool, container, std::move(init), std::plus<>());
+		}
+		template<class _TContainer, class _Ty, class _TBinaryOp, class = impl::enable_if_not_pool_t<_TContainer>>
+		_Ty reduce(const _TContainer& container, _Ty init, _TBinaryOp binary_op) {
+			return mse::parallel::reduce(thread_pool::default_pool(), container, std::move(init), std::move(binary_op));
+		}
+		template<class _TContainer, class _Ty, class = impl::enable_if_not_pool_t<_TContainer>>
+		_Ty reduce(const _TContainer& container, _Ty init) {
+			return mse::parallel::reduce(thread_pool::default_pool(), container, std::move(init), std::plus<>());
+		}
+
+		template<class _TContainer, class _TCompare>
+		void sort(thread_pool& pool, _TContainer& container, _TCompare compare) {
+			const size_t num_elements = container.size();
+			const auto num_chunks = impl::num_chunks_for(pool, num_elements);
+			impl::for_each_chunk(pool, container, num_chunks, [&compare](const impl::TCheckedChunk<impl::element_t<_TContainer>>& chunk, size_t) {
+				std::sort(chunk.begin(), chunk.end(), compare);
+			});
+			/* Then merge adjacent sorted runs pairwise until there's only one run left. */
+			for (size_t run_length_in_chunks = 1; run_length_in_chunks < num_chunks; run_length_in_chunks *= 2) {
+				const size_t num_merges = (num_chunks + 2 * run_length_in_chunks - 1) / (2 * run_length_in_chunks);
+				pool.run_chunks(num_merges, [&](size_t merge_index) {
+					const size_t first_chunk_index = merge_index * 2 * run_length_in_chunks;
+					const size_t middle_chunk_index = std::min(first_chunk_index + run_length_in_chunks, num_chunks);
+					const size_t last_chunk_index = std::min(first_chunk_index + 2 * run_length_in_chunks, num_chunks);
+					const auto first_index = impl::chunk_first_index(num_elements, num_chunks, first_chunk_index);
+					const auto middle_index = impl::chunk_first_index(num_elements, num_chunks, middle_chunk_index);
+					const impl::TCheckedChunk<impl::element_t<_TContainer>> run_pair(container, first_index
+						, impl::chunk_first_index(num_elements, num_chunks, last_chunk_index));
+					std::inplace_merge(run_pair.begin(), run_pair.begin() + (middle_index - first_index), run_pair.end(), compare);
+				});
+			}
+		}
+		template<class _TContainer>
+		void sort(thread_pool& pool, _TContainer& container) {
+			mse::parallel::sort(pool, container, std::less<>());
+		}
+		template<class _TContainer, class _TCompare, class = impl::enable_if_not_pool_t<_TContainer>>
+		void sort(_TContainer& container, _TCompare compare) {
+			mse::parallel::sort(thread_pool::default_pool(), container, std::move(compare));
+		}
+		template<class _TContainer, class = impl::enable_if_not_pool_t<_TContainer>>
+		void sort(_TContainer& container) {
+			mse::parallel::sort(thread_pool::default_pool(), container, std::less<>());
+		}
+
+		/* dest must have at least as many elements as src. src and dest may be the same container. binary_op is
+		assumed to be associative. */
+		template<class _TSrcContainer, class _TDestContainer, class _TBinaryOp>
+		void inclusive_scan(thread_pool& pool, const _TSrcContainer& src, _TDestContainer& dest, _TBinaryOp binary_op) {
+			typedef typename std::remove_const<impl::element_t<_TDestContainer>>::type dest_value_t;
+			const size_t num_elements = src.size();
+			if (dest.size() < num_elements) {
+				MSE_THROW(parallel_range_error("destination is smaller than source - void inclusive_scan(thread_pool& pool, const _TSrcContainer& src, _TDestContainer& dest, _TBinaryOp binary_op) - mse::parallel"));
+			}
+			const auto num_chunks = impl::num_chunks_for(pool, num_elements);
+
+			/* First we (concurrently) compute the total of each chunk, */
+			std::vector<std::unique_ptr<dest_value_t>> chunk_totals(num_chunks);
+			impl::for_each_chunk(pool, src, num_chunks, [&](const impl::TCheckedChunk<impl::element_t<const _TSrcContainer>>& chunk, size_t chunk_index) {
+				if ((chunk_index + 1 < num_chunks) && (1 <= chunk.size())) {
+					dest_value_t total = chunk[0];
+					for (size_t i = 1; i < chunk.size(); i += 1) {
+						total = binary_op(std::move(total), chunk[i]);
+					}
+					chunk_totals[chunk_index] = std::unique_ptr<dest_value_t>(new dest_value_t(std::move(total)));
+				}
+			});
+			/* then turn those totals into the (exclusive) prefix of each chunk, */
+			std::vector<std::unique_ptr<dest_value_t>> chunk_prefixes(num_chunks);
+			for (size_t chunk_index = 1; chunk_index < num_chunks; chunk_index += 1) {
+				const auto& prev_prefix_uqptr = chunk_prefixes[chunk_index - 1];
+				const auto& prev_total_uqptr = chunk_totals[chunk_index - 1];
+				if (prev_prefix_uqptr && prev_total_uqptr) {
+					chunk_prefixes[chunk_index] = std::unique_ptr<dest_value_t>(new dest_value_t(binary_op(*prev_prefix_uqptr, *prev_total_uqptr)));
+				}
+				else if (prev_prefix_uqptr) {
+					chunk_prefixes[chunk_index] = std::unique_ptr<dest_value_t>(new dest_value_t(*prev_prefix_uqptr));
+				}
+				else if (prev_total_uqptr) {
+					chunk_prefixes[chunk_index] = std::unique_ptr<dest_value_t>(new dest_value_t(*prev_total_uqptr));
+				}
+			}
+			/* and then (concurrently) scan each chunk starting from its prefix. */
+			impl::for_each_chunk(pool, src, num_chunks, [&](const impl::TCheckedChunk<impl::element_t<const _TSrcContainer>>& src_chunk, size_t chunk_index) {
+				if (1 > src_chunk.size()) { return; }
+				const auto first_index = impl::chunk_first_index(num_elements, num_chunks, chunk_index);
+				const impl::TCheckedChunk<impl::element_t<_TDestContainer>> dest_chunk(dest, first_index, first_index + src_chunk.size());
+				const auto& prefix_uqptr = chunk_prefixes[chunk_index];
+				dest_value_t accumulator = prefix_uqptr ? binary_op(*prefix_uqptr, src_chunk[0]) : dest_value_t(src_chunk[0]);
+				dest_chunk[0] = accumulator;
+				for (size_t i = 1; i < src_chunk.size(); i += 1) {
+					accumulator = binary_op(std::move(accumulator), src_chunk[i]);
+					dest_chunk[i] = accumulator;
+				}
+			});
+		}
+		template<class _TSrcContainer, class _TDestContainer>
+		void inclusive_scan(thread_pool& pool, const _TSrcContainer& src, _TDestContainer& dest) {
+			mse::parallel::inclusive_scan(pool, src, dest, std::plus<>());
+		}
+		template<class _TSrcContainer, class _TDestContainer, class _TBinaryOp, class = impl::enable_if_not_pool_t<_TSrcContainer>>
+		void inclusive_scan(const _TSrcContainer& src, _TDestContainer& dest, _TBinaryOp binary_op) {
+			mse::parallel::inclusive_scan(thread_pool::default_pool(), src, dest, std::move(binary_op));
+		}
+		template<class _TSrcContainer, class _TDestContainer, class = impl::enable_if_not_pool_t<_TSrcContainer>>
+		void inclusive_scan(const _TSrcContainer& src, _TDestContainer& dest) {
+			mse::parallel::inclusive_scan(thread_pool::default_pool(), src, dest, std::plus<>());
+		}
+	}
+}
+
+#undef MSE_THROW
+
+#endif // MSEPARALLEL_H_
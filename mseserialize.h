@@ -0,0 +1,429 @@
+// Copyright (c) 2015 Noah Lopez
+// Use, modification, and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#ifndef MSESERIALIZE_H_
+#define MSESERIALIZE_H_
+
+#include "msemsevector.h"
+#include "msemstdvector.h"
+#include "msemsearray.h"
+#include "msemstdarray.h"
+#include "mseoptional.h"
+#include "mseprimitives.h"
+#include <vector>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <cassert>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <algorithm>
+#include <memory>
+
+#ifdef _WIN32
+#include <io.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#else /*_WIN32*/
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif /*_WIN32*/
+
+#ifdef MSE_CUSTOM_THROW_DEFINITION
+#include <iostream>
+#define MSE_THROW(x) MSE_CUSTOM_THROW_DEFINITION(x)
+#else // MSE_CUSTOM_THROW_DEFINITION
+#define MSE_THROW(x) throw(x)
+#endif // MSE_CUSTOM_THROW_DEFINITION
+
+namespace mse {
+
+	class serialization_error : public std::runtime_error { public:
+		using std::runtime_error::runtime_error;
+	};
+
+	namespace serial {
+
+		static const size_t sc_default_buffer_size = 64 * 1024;
+
+		/* CFdWriter writes to a file descriptor through a buffer. Writes at least as large as the buffer bypass it. The
+		buffer is flushed when the writer is destroyed, but since errors can't be reported from the destructor, you
+		should call flush() explicitly when you're done. */
+		class CFdWriter {
+		public:
+			explicit CFdWriter(int fd, size_t buffer_size = sc_default_buffer_size) : m_fd(fd), m_buffer(std::max(size_t(1), buffer_size)) {}
+			~CFdWriter() {
+				try { flush(); }
+				catch (...) {}
+			}
+
+			void write(const void* src, size_t count) {
+				if (m_buffer.size() - m_buffered_count < count) { flush(); }
+				if (m_buffer.size() <= count) {
+					write_all(static_cast<const unsigned char*>(src), count);
+				}
+				else if (0 < count) {
+					std::memcpy(m_buffer.data() + m_buffered_count, src, count);
+					m_buffered_count += count;
+				}
+			}
+			void flush() {
+				const auto count = m_buffered_count;
+				m_buffered_count = 0;
+				write_all(m_buffer.data(), count);
+			}
+
+		private:
+			CFdWriter(const CFdWriter&) = delete;
+			CFdWriter& operator=(const CFdWriter&) = delete;
+
+			void write_all(const unsigned char* src, size_t count) {
+				while (0 < count) {
+					/* (Individual writes are kept under 1GB, which all platforms can handle.) */
+					const auto request_count = std::min(count, size_t(1) << 30);
+#ifdef _WIN32
+					const auto res = ::_write(m_fd, src, static_cast<unsigned int>(request_count));
+#else /*_WIN32*/
+					const auto res = ::write(m_fd, src, request_count);
+#endif /*_WIN32*/
+					if (0 > res) {
+						if (EINTR == errno) { continue; }
+						MSE_THROW(serialization_error("write failed - void write_all(const unsigned char* src, size_t count) - CFdWriter"));
+					}
+					src += size_t(res);
+					count -= size_t(res);
+				}
+			}
+
+			int m_fd = -1;
+			std::vector<unsigned char> m_buffer;
+			size_t m_buffered_count = 0;
+		};
+
+		/* CFdReader reads from a file descriptor through a buffer. Reads at least as large as the buffer bypass it. If
+		the file descriptor refers to a regular file, the number of bytes remaining in the file is obtained on
+		construction, so that lengths read from the input can be validated before anything is allocated for them. You can
+		also set a limit on the number of bytes to be read, which is useful when reading from pipes or sockets. */
+		class CFdReader {
+		public:
+			explicit CFdReader(int fd, size_t buffer_size = sc_default_buffer_size) : m_fd(fd), m_buffer(std::max(size_t(1), buffer_size)) {
+#ifdef _WIN32
+				struct _stati64 file_stat;
+				if ((0 == ::_fstati64(fd, &file_stat)) && (_S_IFREG & file_stat.st_mode)) {
+					const long long position = ::_lseeki64(fd, 0, SEEK_CUR);
+#else /*_WIN32*/
+				struct stat file_stat;
+				if ((0 == ::fstat(fd, &file_stat)) && S_ISREG(file_stat.st_mode)) {
+					const long long position = static_cast<long long>(::lseek(fd, 0, SEEK_CUR));
+#endif /*_WIN32*/
+					const long long file_size = static_cast<long long>(file_stat.st_size);
+					if ((0 <= position) && (position <= file_size)) {
+						set_byte_limit(static_cast<unsigned long long>(file_size - position));
+					}
+				}
+			}
+
+			/* Limits the number of (further) bytes that will be read. */
+			void set_byte_limit(unsigned long long limit) {
+				const size_t size_t_limit = (static_cast<unsigned long long>(size_t(-1)) < limit) ? size_t(-1) : size_t(limit);
+				m_remaining = std::min(m_remaining, size_t_limit);
+				m_input_size_is_known = true;
+			}
+			bool input_size_is_known() const { return m_input_size_is_known; }
+			/* An upper bound on the number of bytes that can still be read (if the input size is known). */
+			size_t remaining() const { return m_remaining; }
+
+			void read(void* dest, size_t count) {
+				if (m_remaining < count) { MSE_THROW(serialization_error("unexpected end of input - void read(void* dest, size_t count) - CFdReader")); }
+				m_remaining -= count;
+				auto dest_ptr = static_cast<unsigned char*>(dest);
+				const auto from_buffer_count = std::min(count, m_buffered_end - m_buffered_start);
+				if (0 < from_buffer_count) {
+					std::memcpy(dest_ptr, m_buffer.data() + m_buffered_start, from_buffer_count);
+					m_buffered_start += from_buffer_count;
+					dest_ptr += from_buffer_count;
+					count -= from_buffer_count;
+				}
+				if (m_buffer.size() <= count) {
+					while (0 < count) {
+						const auto res = read_some(dest_ptr, count);
+						dest_ptr += res;
+						count -= res;
+					}
+				}
+				else if (0 < count) {
+					/* Refill the buffer, without reading past the byte limit (if there is one). */
+					const auto fill_limit = count + std::min(m_remaining, m_buffer.size() - count);
+					m_buffered_start = 0;
+					m_buffered_end = 0;
+					while (m_buffered_end < count) {
+						m_buffered_end += read_some(m_buffer.data() + m_buffered_end, fill_limit - m_buffered_end);
+					}
+					std::memcpy(dest_ptr, m_buffer.data(), count);
+					m_buffered_start = count;
+				}
+			}
+
+		private:
+			CFdReader(const CFdReader&) = delete;
+			CFdReader& operator=(const CFdReader&) = delete;
+
+			size_t read_some(unsigned char* dest, size_t max_count) {
+				while (true) {
+					const auto request_count = std::min(max_count, size_t(1) << 30);
+#ifdef _WIN32
+					const auto res = ::_read(m_fd, dest, static_cast<unsigned int>(request_count));
+#else /*_WIN32*/
+					const auto res = ::read(m_fd, dest, request_count);
+#endif /*_WIN32*/
+					if (0 < res) { return size_t(res); }
+					if (0 == res) { MSE_THROW(serialization_error("unexpected end of input - size_t read_some(unsigned char* dest, size_t max_count) - CFdReader")); }
+					if (EINTR != errno) { MSE_THROW(serialization_error("read failed - size_t read_some(unsigned char* dest, size_t max_count) - CFdReader")); }
+				}
+			}
+
+			int m_fd = -1;
+			std::vector<unsigned char> m_buffer;
+			size_t m_buffered_start = 0;
+			size_t m_buffered_end = 0;
+			size_t m_remaining = size_t(-1);
+			bool m_input_size_is_known = false;
+		};
+
+		/* Types whose in-memory representation is written and read as is. By default, the arithmetic types other than bool
+		(which is written as a validated byte). You can specialize this for your own trivially copyable types, as long as
+		any bit pattern is a valid value for them (so, for example, not for types containing pointers or enums). */
+		template<class _Ty>
+		struct is_bitwise_serializable : std::integral_constant<bool, std::is_arithmetic<_Ty>::value && (!std::is_same<_Ty, bool>::value)> {};
+
+		/* TSerializer<> is specialized for each supported type. Each specialization provides static write() and read()
+		functions, and the minimum number of bytes a value of the type occupies in the serialized form (used to validate
+		lengths read from the input). */
+		template<class _Ty, class = void>
+		struct TSerializer;
+
+		/* Writes obj to writer, which can be a CFdWriter, or any type with a write(const void* src, size_t count) member
+		function. The format uses the platform's native byte order and type sizes. */
+		template<class _TWriter, class _Ty>
+		void serialize(_TWriter& writer, const _Ty& obj) { TSerializer<_Ty>::write(writer, obj); }
+		/* Reads obj from reader, which can be a CFdReader, or any type with read(void* dest, size_t count),
+		remaining() and input_size_is_known() member functions. If an exception is thrown, obj is left in a valid, but
+		unspecified state. */
+		template<class _TReader, class _Ty>
+		void deserialize(_TReader& reader, _Ty& obj) { TSerializer<_Ty>::read(reader, obj); }
+
+		namespace impl {
+			/* Containers with unknown input size are filled in chunks of (about) this many bytes, so that a corrupt
+			length can't cause a large allocation before the corresponding input has actually been read. */
+			static const size_t sc_read_chunk_size = 4 * 1024 * 1024;
+
+			template<class _TWriter>
+			void write_length(_TWriter& writer, size_t length) {
+				const auto length64 = static_cast<uint64_t>(length);
+				writer.write(&length64, sizeof(length64));
+			}
+			template<class _TReader>
+			size_t read_length(_TReader& reader, size_t min_element_size) {
+				uint64_t length64 = 0;
+				reader.read(&length64, sizeof(length64));
+				if ((static_cast<uint64_t>(size_t(-1)) < length64)
+					|| (reader.input_size_is_known() && (0 < min_element_size) && (reader.remaining() / min_element_size < size_t(length64)))) {
+					MSE_THROW(serialization_error("length exceeds the remaining input - size_t read_length(_TReader& reader, size_t min_element_size) - mse::serial"));
+				}
+				return size_t(length64);
+			}
+
+			template<class _TWriter, class _Ty>
+			void write_elements(_TWriter& writer, const _Ty* ptr, size_t count, std::true_type/*bitwise*/) {
+				if (0 < count) { writer.write(ptr, count * sizeof(_Ty)); }
+			}
+			template<class _TWriter, class _Ty>
+			void write_elements(_TWriter& writer, const _Ty* ptr, size_t count, std::false_type/*bitwise*/) {
+				for (size_t i = 0; i < count; i += 1) { TSerializer<_Ty>::write(writer, ptr[i]); }
+			}
+			template<class _TWriter, class _Ty>
+			void write_elements(_TWriter& writer, const _Ty* ptr, size_t count) {
+				write_elements(writer, ptr, count, std::integral_constant<bool, is_bitwise_serializable<_Ty>::value>());
+			}
+			template<class _TReader, class _Ty>
+			void read_elements(_TReader& reader, _Ty* ptr, size_t count, std::true_type/*bitwise*/) {
+				if (0 < count) { reader.read(ptr, count * sizeof(_Ty)); }
+			}
+			template<class _TReader, class _Ty>
+			void read_elements(_TReader& reader, _Ty* ptr, size_t count, std::false_type/*bitwise*/) {
+				for (size_t i = 0; i < count; i += 1) { TSerializer<_Ty>::read(reader, ptr[i]); }
+			}
+			template<class _TReader, class _Ty>
+			void read_elements(_TReader& reader, _Ty* ptr, size_t count) {
+				read_elements(reader, ptr, count, std::integral_constant<bool, is_bitwise_serializable<_Ty>::value>());
+			}
+
+			/* Serialized as a length followed by the elements. */
+			template<class _TVector>
+			struct TVectorSerializer {
+				typedef typename _TVector::value_type value_type;
+				static const size_t min_size = sizeof(uint64_t);
+				template<class _TWriter>
+				static void write(_TWriter& writer, const _TVector& vec) {
+					write_length(writer, vec.size());
+					write_elements(writer, vec.data(), vec.size());
+				}
+				template<class _TReader>
+				static void read(_TReader& reader, _TVector& vec) {
+					const auto count = read_length(reader, TSerializer<value_type>::min_size);
+					vec.clear();
+					if (reader.input_size_is_known()) { vec.reserve(count); }
+					const size_t chunk_count = std::max(size_t(1), sc_read_chunk_size / sizeof(value_type));
+					size_t num_read = 0;
+					while (num_read < count) {
+						const auto num_to_read = std::min(chunk_count, count - num_read);
+						vec.resize(num_read + num_to_read);
+						read_elements(reader, vec.data() + num_read, num_to_read);
+						num_read += num_to_read;
+					}
+				}
+			};
+			/* Serialized as a length (which is validated on reading) followed by the elements. */
+			template<class _TArray, size_t _Size>
+			struct TArraySerializer {
+				typedef typename _TArray::value_type value_type;
+				static const size_t min_size = sizeof(uint64_t);
+				template<class _TWriter>
+				static void write(_TWriter& writer, const _TArray& arr) {
+					write_length(writer, _Size);
+					write_elements(writer, arr.data(), _Size);
+				}
+				template<class _TReader>
+				static void read(_TReader& reader, _TArray& arr) {
+					if (_Size != read_length(reader, 0)) { MSE_THROW(serialization_error("array size mismatch - static void read(_TReader& reader, _TArray& arr) - TArraySerializer")); }
+					read_elements(reader, arr.data(), _Size);
+				}
+			};
+		}
+
+		template<class _Ty>
+		struct TSerializer<_Ty, typename std::enable_if<is_bitwise_serializable<_Ty>::value>::type> {
+			static_assert(std::is_trivially_copyable<_Ty>::value, "bitwise serializable types must be trivially copyable");
+			static const size_t min_size = sizeof(_Ty);
+			template<class _TWriter>
+			static void write(_TWriter& writer, const _Ty& value) { writer.write(std::addressof(value), sizeof(_Ty)); }
+			template<class _TReader>
+			static void read(_TReader& reader, _Ty& value) { reader.read(std::addressof(value), sizeof(_Ty)); }
+		};
+		template<>
+		struct TSerializer<bool> {
+			static const size_t min_size = 1;
+			template<class _TWriter>
+			static void write(_TWriter& writer, const bool& value) {
+				const unsigned char byte = value ? 1 : 0;
+				writer.write(&byte, 1);
+			}
+			template<class _TReader>
+			static void read(_TReader& reader, bool& value) {
+				unsigned char byte = 0;
+				reader.read(&byte, 1);
+				if (1 < byte) { MSE_THROW(serialization_error("invalid bool value - static void read(_TReader& reader, bool& value) - TSerializer<bool>")); }
+				value = (1 == byte);
+			}
+		};
+
+#ifndef MSE_PRIMITIVES_DISABLED
+		/* CInt and CSize_t are serialized as 64 bit integers, and the range is checked when they're read. */
+		template<>
+		struct TSerializer<CInt> {
+			static const size_t min_size = sizeof(int64_t);
+			template<class _TWriter>
+			static void write(_TWriter& writer, const CInt& value) {
+				const auto value64 = static_cast<int64_t>(static_cast<MSE_CINT_BASE_INTEGER_TYPE>(value));
+				writer.write(&value64, sizeof(value64));
+			}
+			template<class _TReader>
+			static void read(_TReader& reader, CInt& value) {
+				int64_t value64 = 0;
+				reader.read(&value64, sizeof(value64));
+				value = static_cast<long long>(value64);
+			}
+		};
+		template<>
+		struct TSerializer<CSize_t> {
+			static const size_t min_size = sizeof(uint64_t);
+			template<class _TWriter>
+			static void write(_TWriter& writer, const CSize_t& value) {
+				const auto value64 = static_cast<uint64_t>(size_t(value));
+				writer.write(&value64, sizeof(value64));
+			}
+			template<class _TReader>
+			static void read(_TReader& reader, CSize_t& value) {
+				uint64_t value64 = 0;
+				reader.read(&value64, sizeof(value64));
+				if (static_cast<uint64_t>(size_t(-1)) < value64) { MSE_THROW(serialization_error("value out of range - static void read(_TReader& reader, CSize_t& value) - TSerializer<CSize_t>")); }
+				value = size_t(value64);
+			}
+		};
+		template<>
+		struct TSerializer<CBool> {
+			static const size_t min_size = 1;
+			template<class _TWriter>
+			static void write(_TWriter& writer, const CBool& value) { TSerializer<bool>::write(writer, bool(value)); }
+			template<class _TReader>
+			static void read(_TReader& reader, CBool& value) {
+				bool bool_value = false;
+				TSerializer<bool>::read(reader, bool_value);
+				value = bool_value;
+			}
+		};
+#endif /*!MSE_PRIMITIVES_DISABLED*/
+
+		template<class _Ty, class _A>
+		struct TSerializer<std::vector<_Ty, _A>> : public impl::TVectorSerializer<std::vector<_Ty, _A>> {};
+		template<class _Ty, class _A>
+		struct TSerializer<msevector<_Ty, _A>> : public impl::TVectorSerializer<msevector<_Ty, _A>> {};
+#ifndef MSE_MSTDVECTOR_DISABLED
+		template<class _Ty, class _A>
+		struct TSerializer<mstd::vector<_Ty, _A>> : public impl::TVectorSerializer<mstd::vector<_Ty, _A>> {};
+#endif /*!MSE_MSTDVECTOR_DISABLED*/
+
+		template<class _Ty, size_t _Size>
+		struct TSerializer<std::array<_Ty, _Size>> : public impl::TArraySerializer<std::array<_Ty, _Size>, _Size> {};
+		template<class _Ty, size_t _Size>
+		struct TSerializer<msearray<_Ty, _Size>> : public impl::TArraySerializer<msearray<_Ty, _Size>, _Size> {};
+#ifndef MSE_MSTDARRAY_DISABLED
+		template<class _Ty, size_t _Size>
+		struct TSerializer<mstd::array<_Ty, _Size>> : public impl::TArraySerializer<mstd::array<_Ty, _Size>, _Size> {};
+#endif /*!MSE_MSTDARRAY_DISABLED*/
+
+		/* Serialized as a (validated) "has value" byte, followed by the value if there is one. */
+		template<class _Ty>
+		struct TSerializer<optional<_Ty>> {
+			static const size_t min_size = 1;
+			template<class _TWriter>
+			static void write(_TWriter& writer, const optional<_Ty>& opt) {
+				TSerializer<bool>::write(writer, opt.has_value());
+				if (opt.has_value()) { TSerializer<_Ty>::write(writer, opt.value()); }
+			}
+			template<class _TReader>
+			static void read(_TReader& reader, optional<_Ty>& opt) {
+				bool has_value = false;
+				TSerializer<bool>::read(reader, has_value);
+				if (has_value) {
+					if (!opt.has_value()) { opt.emplace(); }
+					TSerializer<_Ty>::read(reader, opt.value());
+				}
+				else {
+					opt.reset();
+				}
+			}
+		};
+	}
+}
+
+#undef MSE_THROW
+
+#endif /*ndef MSESERIALIZE_H_*/
@@ -0,0 +1,189 @@
+// Copyright (c) 2015 Noah Lopez
+// Use, modification, and distribution is subject to the Boost Software
+// License, Version 1.0. (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+#ifndef MSESPAN_H_
+#define MSESPAN_H_
+
+#include "msemsevector.h"
+#include "msemsearray.h"
+#include <cstddef>
+#include <cassert>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#ifdef MSE_CUSTOM_THROW_DEFINITION
+#include <iostream>
+#define MSE_THROW(x) MSE_CUSTOM_THROW_DEFINITION(x)
+#else // MSE_CUSTOM_THROW_DEFINITION
+#define MSE_THROW(x) throw(x)
+#endif // MSE_CUSTOM_THROW_DEFINITION
+
+namespace mse {
+
+	class span_range_error : public std::range_error { public:
+		using std::range_error::range_error;
+	};
+
+	/* TXScopeSpan<> is a view of a contiguous range of elements of an msevector<> or msearray<>. The range is bounds
+	checked once, when the span is created, so (in non-debug builds) element access through the span is unchecked and
+	loops over it can run at native (and vectorizable) speed. Spans can only be obtained from scope pointers, so they
+	won't outlive the container, and while a span of an msevector<> exists, any operation that could change the vector's
+	size or relocate its elements will throw an exception. */
+	template<typename _Ty>
+	class TXScopeSpan {
+	public:
+		typedef _Ty element_type;
+		typedef typename std::remove_cv<_Ty>::type value_type;
+		typedef size_t size_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef _Ty* pointer;
+		typedef _Ty& reference;
+		typedef _Ty* iterator;
+
+		TXScopeSpan(const TXScopeSpan& src_cref) : m_data(src_cref.m_data), m_size(src_cref.m_size), m_lock_count_ptr(src_cref.m_lock_count_ptr) {
+			lock();
+		}
+		template<typename _Ty2, class = typename std::enable_if<std::is_convertible<_Ty2(*)[], _Ty(*)[]>::value, void>::type>
+		TXScopeSpan(const TXScopeSpan<_Ty2>& src_cref) : m_data(src_cref.m_data), m_size(src_cref.m_size), m_lock_count_ptr(src_cref.m_lock_count_ptr) {
+			lock();
+		}
+		~TXScopeSpan() {
+			unlock();
+		}
+
+		size_type size() const { return m_size; }
+		bool empty() const { return (0 == m_size); }
+		pointer data() const { return m_data; }
+		iterator begin() const { return m_data; }
+		iterator end() const { return m_data + m_size; }
+
+		/* The range was validated when the span was created, so element access is not (otherwise) bounds checked. */
+		reference operator[](size_type index) const {
+			assert(index < m_size);
+			return m_data[index];
+		}
+		reference at(size_type index) const {
+			if (m_size <= index) { MSE_THROW(span_range_error("index out of range - reference at(size_type index) const - TXScopeSpan")); }
+			return m_data[index];
+		}
+		reference front() const {
+			if (0 == m_size) { MSE_THROW(span_range_error("front() on empty - reference front() const - TXScopeSpan")); }
+			return m_data[0];
+		}
+		reference back() const {
+			if (0 == m_size) { MSE_THROW(span_range_error("back() on empty - reference back() const - TXScopeSpan")); }
+			return m_data[m_size - 1];
+		}
+		TXScopeSpan subspan(size_type offset, size_type count) const {
+			if ((m_size < offset) || (m_size - offset < count)) { MSE_THROW(span_range_error("out of bounds section - TXScopeSpan subspan(size_type offset, size_type count) const - TXScopeSpan")); }
+			return TXScopeSpan(m_data + offset, count, m_lock_count_ptr);
+		}
+		TXScopeSpan first(size_type count) const { return subspan(0, count); }
+		TXScopeSpan last(size_type count) const {
+			if (m_size < count) { MSE_THROW(span_range_error("out of bounds section - TXScopeSpan last(size_type count) const - TXScopeSpan")); }
+			return subspan(m_size - count, count);
+		}
+
+		void xscope_tag() const {}
+
+	private:
+		TXScopeSpan(pointer data, size_type size, size_t* lock_count_ptr) : m_data(data), m_size(size), m_lock_count_ptr(lock_count_ptr) {
+			lock();
+		}
+		TXScopeSpan& operator=(const TXScopeSpan& _Right_cref) = delete;
+		void* operator new(size_t size) { return ::operator new(size); }
+
+		void lock() {
+			if (m_lock_count_ptr) { (*m_lock_count_ptr) += 1; }
+		}
+		void unlock() {
+			if (m_lock_count_ptr) { assert(1 <= (*m_lock_count_ptr)); (*m_lock_count_ptr) -= 1; }
+		}
+
+		pointer m_data = nullptr;
+		size_type m_size = 0;
+		/* Points to the "structure lock" count of the owning msevector<> (or is null if the owner, like msearray<>, can't be
+		resized). */
+		size_t* m_lock_count_ptr = nullptr;
+
+		template<typename _Ty2> friend class TXScopeSpan;
+		friend struct impl::xscope_span_maker;
+	};
+
+	namespace impl {
+		struct xscope_span_maker {
+			static void check_section(size_t container_size, size_t offset, size_t count) {
+				if ((container_size < offset) || (container_size - offset < count)) {
+					MSE_THROW(span_range_error("out of bounds section - make_xscope_span() - TXScopeSpan"));
+				}
+			}
+
+			template<class _Ty, class _A>
+			static TXScopeSpan<_Ty> make(msevector<_Ty, _A>& container_ref, size_t offset, size_t count) {
+				check_section(container_ref.size(), offset, count);
+				return TXScopeSpan<_Ty>(container_ref.data() + offset, count, &(container_ref.m_structure_lock_count));
+			}
+			template<class _Ty, class _A>
+			static TXScopeSpan<const _Ty> make(const msevector<_Ty, _A>& container_cref, size_t offset, size_t count) {
+				check_section(container_cref.size(), offset, count);
+				return TXScopeSpan<const _Ty>(container_cref.data() + offset, count, &(container_cref.m_structure_lock_count));
+			}
+			template<class _Ty, size_t _Size>
+			static TXScopeSpan<_Ty> make(msearray<_Ty, _Size>& container_ref, size_t offset, size_t count) {
+				check_section(_Size, offset, count);
+				return TXScopeSpan<_Ty>(container_ref.data() + offset, count, nullptr);
+			}
+			template<class _Ty, size_t _Size>
+			static TXScopeSpan<const _Ty> make(const msearray<_Ty, _Size>& container_cref, size_t offset, size_t count) {
+				check_section(_Size, offset, count);
+				return TXScopeSpan<const _Ty>(container_cref.data() + offset, count, nullptr);
+			}
+		};
+
+		template<class _TContainer>
+		using xscope_span_t = decltype(xscope_span_maker::make(std::declval<_TContainer&>(), size_t(0), size_t(0)));
+	}
+
+	/* make_xscope_span() returns a span of the whole container, or of the section starting at "offset" with "count" elements,
+	targeted by the given scope pointer. An exception is thrown if the section isn't within the container's bounds. */
+	template<class _TContainer>
+	impl::xscope_span_t<_TContainer> make_xscope_span(const mse::TXScopeFixedPointer<_TContainer>& owner_ptr, size_t offset, size_t count) {
+		return impl::xscope_span_maker::make(*owner_ptr, offset, count);
+	}
+	template<class _TContainer>
+	impl::xscope_span_t<_TContainer> make_xscope_span(const mse::TXScopeFixedPointer<_TContainer>& owner_ptr) {
+		return impl::xscope_span_maker::make(*owner_ptr, 0, (*owner_ptr).size());
+	}
+	template<class _TContainer>
+	impl::xscope_span_t<const _TContainer> make_xscope_span(const mse::TXScopeFixedConstPointer<_TContainer>& owner_ptr, size_t offset, size_t count) {
+		return impl::xscope_span_maker::make(*owner_ptr, offset, count);
+	}
+	template<class _TContainer>
+	impl::xscope_span_t<const _TContainer> make_xscope_span(const mse::TXScopeFixedConstPointer<_TContainer>& owner_ptr) {
+		return impl::xscope_span_maker::make(*owner_ptr, 0, (*owner_ptr).size());
+	}
+	template<class _TContainer, class _TLeasePointerType>
+	impl::xscope_span_t<_TContainer> make_xscope_span(const mse::TXScopeWeakFixedPointer<_TContainer, _TLeasePointerType>& owner_ptr, size_t offset, size_t count) {
+		return impl::xscope_span_maker::make(*owner_ptr, offset, count);
+	}
+	template<class _TContainer, class _TLeasePointerType>
+	impl::xscope_span_t<_TContainer> make_xscope_span(const mse::TXScopeWeakFixedPointer<_TContainer, _TLeasePointerType>& owner_ptr) {
+		return impl::xscope_span_maker::make(*owner_ptr, 0, (*owner_ptr).size());
+	}
+	template<class _TContainer, class _TLeasePointerType>
+	impl::xscope_span_t<const _TContainer> make_xscope_span(const mse::TXScopeWeakFixedConstPointer<_TContainer, _TLeasePointerType>& owner_ptr, size_t offset, size_t count) {
+		return impl::xscope_span_maker::make(*owner_ptr, offset, count);
+	}
+	template<class _TContainer, class _TLeasePointerType>
+	impl::xscope_span_t<const _TContainer> make_xscope_span(const mse::TXScopeWeakFixedConstPointer<_TContainer, _TLeasePointerType>& owner_ptr) {
+		return impl::xscope_span_maker::make(*owner_ptr, 0, (*owner_ptr).size());
+	}
+}
+
+#undef MSE_THROW
+
+#endif // MSESPAN_H_
@@ -49,6 +49,11 @@ them to be enabled. */
 #include "mserefcountingofrelaxedregistered.h"
 #include "msescope.h"
 #include "mseasyncshared.h"
+#include "mseparallel.h"
+#include "msespan.h"
+#include "msebulk.h"
+#include "msemapped.h"
+#include "mseserialize.h"
 #include "msepoly.h"
 #include "msemsearray.h"
 #include "msemstdarray.h"
@@ -66,10 +71,14 @@ them to be enabled. */
 //include <thread>
 //include <sstream>
 #include <future>
+#include <cmath>
+#include <fstream>
+#include <cstdio>
 
 /* This block of includes is required for the mse::TRegisteredRefWrapper example */
 #include <algorithm>
 #include <list>
+#include <deque>
 #include <vector>
 #include <iostream>
 #include <numeric>
@@ -125,6 +134,41 @@ public:
 		return mse::make_pointer_to_member(safe_this->m_string1, safe_this);
 	}
 
+	/* Just an example of a custom allocator. It counts the number of allocations. */
+	static size_t& number_of_allocations_ref() {
+		static size_t s_number_of_allocations = 0;
+		return s_number_of_allocations;
+	}
+	template<class _Ty>
+	class CCountingAllocator : public std::allocator<_Ty> {
+	public:
+		typedef _Ty value_type;
+		template<class _Ty2> struct rebind { typedef CCountingAllocator<_Ty2> other; };
+		CCountingAllocator() {}
+		template<class _Ty2> CCountingAllocator(const CCountingAllocator<_Ty2>&) {}
+		_Ty* allocate(size_t n) {
+			number_of_allocations_ref() += 1;
+			return std::allocator<_Ty>::allocate(n);
+		}
+	};
+
+	/* Used in the benchmarks to compare the cost of creating many short vectors. */
+	template<class _TVector>
+	static double create_short_lists(int number_of_lists) {
+		int sum = 0;
+		auto t1 = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < number_of_lists; i += 1) {
+			_TVector list1;
+			for (int j = 0; j < 1 + (i % 8); j += 1) {
+				list1.push_back(j);
+			}
+			sum += list1.back();
+		}
+		auto t2 = std::chrono::high_resolution_clock::now();
+		assert(0 < sum);
+		return std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+	}
+
 	std::string m_string1 = "initial text";
 };
 
@@ -184,8 +228,8 @@ int main(int argc, char* argv[])
 		vvi.clear();
 		try {
 			/* At this point, the vint_type object is cleared from vvi, but it has not been deallocated/destructed yet because it
-			"knows" that there is an iterator, namely vi_it, that is still referencing it. At the moment, std::shared_ptrs are being
-			used to achieve this. */
+			"knows" that there is an iterator, namely vi_it, that is still referencing it. (A (non-thread-safe) reference count
+			is used to achieve this.) */
 			auto value = (*vi_it); /* So this is actually ok. vi_it still points to a valid item. */
 			assert(5 == value);
 			vint_type vi2;
@@ -197,6 +241,50 @@ int main(int argc, char* argv[])
 			/* At present, no exception will be thrown. We're still debating whether it'd be better to throw an exception though. */
 		}
 	}
+
+	{
+		/* In "copy-on-write" mode, copies of an mse::mstd::vector<> share its contents until one of them is modified.
+		Obtaining a non-const reference or iterator to an element counts as a modification. */
+		mse::mstd::vector<int> v1 = { 1, 2, 3 };
+		v1.set_copy_on_write(true);
+		const mse::mstd::vector<int> v2 = v1;
+		const auto& v1_cref = v1;
+		assert(v1_cref.data() == v2.data());
+		auto v2_citer = v2.cbegin();
+		v1.push_back(4);
+		assert(v1_cref.data() != v2.data());
+		assert((3 == v2.size()) && (4 == v1.size()));
+		assert(1 == (*v2_citer));
+
+		mse::mstd::vector<int> v3 = v1;
+		auto v3_iter = v3.begin();
+		/* v3 can no longer share its contents as they could be modified through v3_iter. */
+		const mse::mstd::vector<int> v4 = v3;
+		(*v3_iter) = 5;
+		assert((5 == v3[0]) && (1 == v4[0]) && (1 == v1[0]));
+	}
+
+	{
+		/* gen_iterators hold a raw pointer to the element and the vector's "structure generation" at the time they were
+		obtained. Any operation that could change the vector's size or relocate its elements increments the generation,
+		rendering any existing gen_iterators invalid. */
+		mse::mstd::vector<int> v1 = { 1, 2, 3 };
+		auto v1_gen_iter = v1.gen_begin();
+		v1_gen_iter += 1;
+		(*v1_gen_iter) = 5;
+		assert(5 == v1[1]);
+		mse::mstd::vector<int>::gen_const_iterator v1_gen_citer = v1_gen_iter;
+		assert(v1_gen_citer.is_valid() && (1 == v1_gen_citer.position()));
+		v1.push_back(4);
+		assert(!v1_gen_citer.is_valid());
+		try {
+			auto value = (*v1_gen_citer);
+		}
+		catch (...) {
+			std::cerr << "expected exception" << std::endl;
+			/* The push_back() may have relocated the elements, so the gen_iterator is no longer valid. */
+		}
+	}
 #endif // !MSE_MSTDVECTOR_DISABLED
 
 	{
@@ -260,6 +348,20 @@ int main(int argc, char* argv[])
 		/* mse::msevector<> also provides "safe" (bounds checked) versions of the original stl::vector iterators. */
 		std::sort(v.ss_begin(), v.ss_end());
 
+		{
+			/* mse::small_vector<> is an mse::msevector<> that stores up to a given number of elements within the object
+			itself, and only allocates from the heap when it needs more room than that. ipointers remain valid when the
+			elements are moved from the inline storage to the heap. */
+			mse::small_vector<int, 4> sv1 = { 4, 3, 2 };
+			auto sv1_ip1 = sv1.ibegin() + 2;
+			assert(sv1.is_inline());
+			sv1.push_back(1);
+			sv1.insert(sv1.begin(), 5);
+			assert(!sv1.is_inline());
+			assert((2 == *sv1_ip1) && (3 == sv1_ip1.position()));
+			std::sort(sv1.ss_begin(), sv1.ss_end());
+		}
+
 		/* mse::ivector<> is another vector for when safety and "correctness" are more of a priority than performance
 		or compatibility. It is completely safe like mse::mstd::vector<> but only supports the "ipointer" iterators.
 		It does not support the (problematic) standard vector iterator behavior. */
@@ -417,6 +519,121 @@ int main(int argc, char* argv[])
 			auto res3 = *scp_ss_citer4;
 		}
 
+		{
+			/* An "xscope span" checks its bounds once, when it's created, rather than on every element access. While
+			a span of an msevector exists, the vector can't be resized. */
+			mse::TXScopeObj<mse::msevector<int>> vector1_scpobj = mse::msevector<int>{ 1, 2, 3, 4, 5 };
+			mse::TXScopeObj<mse::msearray<int, 3>> array1_scpobj = mse::msearray<int, 3>{ 3, 2, 1 };
+			{
+				auto vector1_span = mse::make_xscope_span(&vector1_scpobj, 1, 3);
+				int sum = 0;
+				for (size_t i = 0; i < vector1_span.size(); i += 1) {
+					sum += vector1_span[i];
+				}
+				assert(9 == sum);
+				mse::TXScopeSpan<const int> vector1_cspan = vector1_span;
+				auto vector1_subspan = vector1_cspan.subspan(1, 2);
+				assert(4 == vector1_subspan.back());
+
+				auto array1_span = mse::make_xscope_span(&array1_scpobj);
+				std::sort(array1_span.begin(), array1_span.end());
+				assert(1 == array1_scpobj[0]);
+
+				try {
+					vector1_scpobj.push_back(6);
+					std::cerr << "unexpected execution" << std::endl;
+				}
+				catch (...) {
+					std::cerr << "expected exception" << std::endl;
+				}
+				try {
+					auto vector1_span2 = mse::make_xscope_span(&vector1_scpobj, 3, 3);
+					std::cerr << "unexpected execution" << std::endl;
+				}
+				catch (...) {
+					std::cerr << "expected exception" << std::endl;
+				}
+			}
+			/* Once the spans are gone, the vector can be resized again. */
+			vector1_scpobj.push_back(6);
+		}
+
+		{
+			/* The "bulk" operations check the container's bounds once per call and then process the elements with
+			vector (SIMD) instructions where available. */
+			mse::msevector<double> vector1(100, 2.0);
+			mse::msearray<double, 100> array1;
+			mse::bulk::fill(array1, 0.5);
+			mse::bulk::copy(mse::msearray<double, 3>{ 1.0, 3.0, -1.0 }, vector1);
+			assert(97 == mse::bulk::count(vector1, 2.0));
+			assert(3 == mse::bulk::find(vector1, 2.0));
+			assert(-1.0 == mse::bulk::min_value(vector1));
+			assert(3.0 == mse::bulk::max_value(vector1));
+			auto sum1 = mse::bulk::sum(vector1);
+			auto dot1 = mse::bulk::dot(vector1, array1);
+			assert(2 * dot1 == sum1);
+			mse::bulk::transform(vector1, array1, vector1, [](double a, double b) { return a * b; });
+
+			/* Bulk operations also work on spans (and so on sections of containers). */
+			mse::TXScopeObj<mse::msevector<int>> vector2_scpobj = mse::msevector<int>(10, 1);
+			mse::bulk::fill(mse::make_xscope_span(&vector2_scpobj, 5, 5), 3);
+			assert(20 == mse::bulk::sum(vector2_scpobj));
+
+			try {
+				mse::bulk::dot(vector1, mse::msearray<double, 3>{ 1.0, 1.0, 1.0 });
+				std::cerr << "unexpected execution" << std::endl;
+			}
+			catch (...) {
+				std::cerr << "expected exception" << std::endl;
+			}
+		}
+
+		{
+			/* TMappedArray<> presents (a section of) a file as an array by mapping the file into memory, rather than
+			reading (copying) it in. */
+			const char* filename = "msetl_example_mapped_array.bin";
+			{
+				std::ofstream ofs(filename, std::ios::binary);
+				for (int i = 0; i < 1000; i += 1) {
+					const double value = 0.5 * i;
+					ofs.write(reinterpret_cast<const char*>(&value), sizeof(value));
+				}
+			}
+			{
+				mse::TMappedArray<double> mapped_array1(filename);
+				assert(1000 == mapped_array1.size());
+				assert(std::binary_search(mapped_array1.cbegin(), mapped_array1.cend(), 250.0));
+				/* A section of the file starting at a given (byte) offset. */
+				mse::TMappedArray<double> mapped_array2(filename, 10 * sizeof(double), 10);
+				assert(5.0 == mapped_array2[0]);
+				/* Mapped arrays can be passed to functions that take a TXScopeRandomAccessConstSection<>. */
+				mse::TXScopeRandomAccessConstSection<double> xscope_section1 = mapped_array2;
+				assert(9.5 == xscope_section1[9]);
+				try {
+					auto value = mapped_array2[10];
+					std::cerr << "unexpected execution" << std::endl;
+				}
+				catch (...) {
+					std::cerr << "expected exception" << std::endl;
+				}
+				try {
+					/* The offset isn't a multiple of alignof(double). */
+					mse::TMappedArray<double> mapped_array3(filename, 1, 10);
+					std::cerr << "unexpected execution" << std::endl;
+				}
+				catch (...) {
+					std::cerr << "expected exception" << std::endl;
+				}
+			}
+			{
+				/* Modifications to the elements of a read-write mapped array are written to the file. */
+				mse::TMappedArray<double, true> mapped_array4(filename);
+				mapped_array4[0] = 7.0;
+				mapped_array4.flush();
+			}
+			std::remove(filename);
+		}
+
 		mse::msearray_test testobj1;
 		testobj1.test1();
 
@@ -508,6 +725,51 @@ int main(int argc, char* argv[])
 		}
 	}
 
+	{
+		/*******************************/
+		/*   binary (de)serialization  */
+		/*******************************/
+
+		/* mse::serial::serialize() and mse::serial::deserialize() write and read the library's containers (and the
+		primitive substitutes) to and from file descriptors in a compact binary form. The elements of containers of
+		arithmetic types are written and read as single contiguous blocks. */
+		mse::msevector<double> vector1 = { 1.0, 2.0, 3.0 };
+		mse::mstd::array<mse::CInt, 2> array1 = { { mse::CInt(4), mse::CInt(-5) } };
+		mse::optional<mse::msearray<int, 2>> optional1 = mse::msearray<int, 2>{ 6, 7 };
+
+		FILE* file_ptr = std::tmpfile();
+		assert(nullptr != file_ptr);
+		{
+			mse::serial::CFdWriter writer1(fileno(file_ptr));
+			mse::serial::serialize(writer1, vector1);
+			mse::serial::serialize(writer1, array1);
+			mse::serial::serialize(writer1, optional1);
+			writer1.flush();
+		}
+		std::rewind(file_ptr);
+		{
+			mse::serial::CFdReader reader1(fileno(file_ptr));
+			mse::msevector<double> vector2;
+			mse::mstd::array<mse::CInt, 2> array2;
+			mse::optional<mse::msearray<int, 2>> optional2;
+			mse::serial::deserialize(reader1, vector2);
+			mse::serial::deserialize(reader1, array2);
+			mse::serial::deserialize(reader1, optional2);
+			assert((vector1 == vector2) && (-5 == array2[1]) && (7 == (*optional2)[1]));
+
+			try {
+				/* Lengths are validated against the remaining input (before any memory is allocated for the elements), and
+				attempting to read past the end of the input results in an exception. */
+				mse::serial::deserialize(reader1, vector2);
+				std::cerr << "unexpected execution" << std::endl;
+			}
+			catch (...) {
+				std::cerr << "expected exception" << std::endl;
+			}
+		}
+		std::fclose(file_ptr);
+	}
+
 	{
 		/**************************/
 		/*   TRegisteredPointer   */
@@ -998,6 +1260,311 @@ int main(int argc, char* argv[])
 				}
 				std::cout << std::endl;
 			}
+			std::cout << std::endl;
+			{
+				/* Inserting or erasing msevector elements updates each of the vector's live ipointers. Unless "lazy" fix-up mode
+				is enabled, in which case each ipointer is updated the next time it is used. */
+#ifndef NDEBUG
+				static const int number_of_edits = 100;
+#else // !NDEBUG
+				static const int number_of_edits = 10000;
+#endif // !NDEBUG
+				static const int number_of_ipointers = 1000;
+				for (int lazy = 0; lazy <= 1; lazy += 1) {
+					mse::msevector<int> msevec1(1000, 0);
+					msevec1.set_lazy_ipointer_fixup(1 == lazy);
+					std::vector<mse::msevector<int>::ipointer> ipointers;
+					ipointers.reserve(number_of_ipointers);
+					for (int i = 0; i < number_of_ipointers; i += 1) {
+						ipointers.push_back(msevec1.ibegin() + (i % 1000));
+					}
+					auto t1 = std::chrono::high_resolution_clock::now();
+					for (int i = 0; i < number_of_edits; i += 1) {
+						msevec1.insert(msevec1.begin() + 500, i);
+						msevec1.erase(msevec1.begin() + 250);
+					}
+					auto t2 = std::chrono::high_resolution_clock::now();
+					auto time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+					std::cout << "mse::msevector insert/erase pairs with " << number_of_ipointers << " live ipointers" << ((1 == lazy) ? " (lazy fix-up)" : "") << ": " << time_span.count() << " seconds.";
+					if (0 == *(ipointers.front())) {
+						std::cout << " ";
+					}
+					assert(999 == ipointers.back().position());
+					std::cout << std::endl;
+				}
+			}
+			{
+				/* Creating or copying an ipointer doesn't (normally) involve any heap allocation. */
+				mse::msevector<int> msevec1(1000, 1);
+				auto ip1 = msevec1.ibegin();
+				int sum = 0;
+				auto t1 = std::chrono::high_resolution_clock::now();
+				for (int i = 0; i < number_of_loops2; i += 1) {
+					auto ip2 = ip1 + (i % 1000);
+					sum += *ip2;
+				}
+				auto t2 = std::chrono::high_resolution_clock::now();
+				auto time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+				std::cout << "mse::msevector ipointer copying: " << time_span.count() << " seconds.";
+				if (number_of_loops2 == sum) {
+					std::cout << " ";
+				}
+				std::cout << std::endl;
+			}
+			{
+				/* mse::small_vector<> avoids heap allocation for short lists. */
+				std::cout << "creating short lists - mse::msevector: " << H::create_short_lists<mse::msevector<int>>(number_of_loops2)
+					<< " seconds, mse::small_vector: " << H::create_short_lists<mse::small_vector<int, 8>>(number_of_loops2) << " seconds." << std::endl;
+			}
+			{
+				/* mse::mstd::vector<> only allocates its msevector<> on the heap once one of its iterators is obtained. */
+				std::cout << "creating short lists - std::vector: " << H::create_short_lists<std::vector<int>>(number_of_loops2)
+					<< " seconds, mse::mstd::vector: " << H::create_short_lists<mse::mstd::vector<int>>(number_of_loops2) << " seconds." << std::endl;
+			}
+			{
+				/* Element access through msevector::operator[] is bounds checked, whereas access through an xscope span
+				isn't (because the span's bounds were checked when it was created). */
+#ifndef NDEBUG
+				static const size_t number_of_elements = 10000;
+#else // !NDEBUG
+				static const size_t number_of_elements = 1000000;
+#endif // !NDEBUG
+				std::vector<double> vec1(number_of_elements, 1.5);
+				mse::TXScopeObj<mse::msevector<double>> msevec1_scpobj = mse::msevector<double>(number_of_elements, 1.5);
+				double results[4] = { 0, 0, 0, 0 };
+				double times[4] = { 0, 0, 0, 0 };
+				for (int method = 0; method < 4; method += 1) {
+					auto t1 = std::chrono::high_resolution_clock::now();
+					double sum = 0;
+					if (0 == method) {
+						for (size_t i = 0; i < number_of_elements; i += 1) {
+							sum += vec1[i] * vec1[i];
+						}
+					}
+					else if (1 == method) {
+						mse::msevector<double>& msevec1_ref = msevec1_scpobj;
+						for (size_t i = 0; i < number_of_elements; i += 1) {
+							sum += msevec1_ref[i] * msevec1_ref[i];
+						}
+					}
+					else if (2 == method) {
+						auto span1 = mse::make_xscope_span(&msevec1_scpobj);
+						for (size_t i = 0; i < span1.size(); i += 1) {
+							sum += span1[i] * span1[i];
+						}
+					}
+					else {
+						sum = mse::bulk::dot(msevec1_scpobj, msevec1_scpobj);
+					}
+					auto t2 = std::chrono::high_resolution_clock::now();
+					results[method] = sum;
+					times[method] = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+				}
+				std::cout << "sum of squares - std::vector: " << times[0] << " seconds, mse::msevector: " << times[1] << " seconds, mse::TXScopeSpan: " << times[2]
+					<< " seconds, mse::bulk::dot(): " << times[3] << " seconds.";
+				if ((results[0] != results[1]) || (results[1] != results[2]) || (results[2] != results[3])) {
+					std::cout << " (results differ)";
+				}
+				std::cout << std::endl;
+			}
+			{
+				/* Removing elements one at a time adjusts each of the vector's live ipointers once per removal, whereas
+				erase_if() adjusts them just once. */
+#ifndef NDEBUG
+				static const int number_of_elements = 1000;
+#else // !NDEBUG
+				static const int number_of_elements = 20000;
+#endif // !NDEBUG
+				static const int number_of_ipointers = 1000;
+				for (int batch = 0; batch <= 1; batch += 1) {
+					mse::msevector<int> msevec1;
+					for (int i = 0; i < number_of_elements; i += 1) {
+						msevec1.push_back(i);
+					}
+					std::vector<mse::msevector<int>::ipointer> ipointers;
+					ipointers.reserve(number_of_ipointers);
+					for (int i = 0; i < number_of_ipointers; i += 1) {
+						ipointers.push_back(msevec1.ibegin() + (i * (number_of_elements / number_of_ipointers)));
+					}
+					auto t1 = std::chrono::high_resolution_clock::now();
+					if (1 == batch) {
+						msevec1.erase_if([](int x) { return (0 != (x % 3)); });
+					}
+					else {
+						for (auto ip = msevec1.ibegin(); msevec1.iend() != ip;) {
+							if (0 != ((*ip) % 3)) {
+								ip = msevec1.erase(ip);
+							}
+							else {
+								++ip;
+							}
+						}
+					}
+					auto t2 = std::chrono::high_resolution_clock::now();
+					auto time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+					std::cout << "mse::msevector filtering with " << number_of_ipointers << " live ipointers" << ((1 == batch) ? " (erase_if())" : "") << ": " << time_span.count() << " seconds.";
+					assert(((number_of_elements + 2) / 3) == int(msevec1.size()));
+					assert(3 == *(ipointers.front() + 1));
+					std::cout << std::endl;
+				}
+			}
+#ifndef MSE_MSTDVECTOR_DISABLED
+			{
+				/* In copy-on-write mode, copies of an mstd::vector share its contents until one of them is modified. */
+#ifndef NDEBUG
+				static const size_t number_of_elements = 1000;
+				static const int number_of_copies = 100;
+#else // !NDEBUG
+				static const size_t number_of_elements = 100000;
+				static const int number_of_copies = 1000;
+#endif // !NDEBUG
+				for (int copy_on_write = 0; copy_on_write <= 1; copy_on_write += 1) {
+					mse::mstd::vector<int> vec1(number_of_elements, 1);
+					vec1.set_copy_on_write(1 == copy_on_write);
+					const auto& vec1_cref = vec1;
+					auto t1 = std::chrono::high_resolution_clock::now();
+					int sum = 0;
+					for (int i = 0; i < number_of_copies; i += 1) {
+						const mse::mstd::vector<int> vec2 = vec1_cref;
+						sum += vec2[size_t(i) % number_of_elements];
+					}
+					auto t2 = std::chrono::high_resolution_clock::now();
+					auto time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+					std::cout << "mse::mstd::vector copying" << ((1 == copy_on_write) ? " (copy-on-write)" : "") << ": " << time_span.count() << " seconds.";
+					assert(number_of_copies == sum);
+					std::cout << std::endl;
+				}
+			}
+			{
+#ifndef NDEBUG
+				static const size_t number_of_elements = 1000;
+				static const int number_of_passes = 100;
+#else // !NDEBUG
+				static const size_t number_of_elements = 100000;
+				static const int number_of_passes = 1000;
+#endif // !NDEBUG
+				mse::mstd::vector<int> vec1(number_of_elements, 1);
+				double times[2];
+				long long int sums[2] = { 0, 0 };
+				{
+					auto t1 = std::chrono::high_resolution_clock::now();
+					for (int i = 0; i < number_of_passes; i += 1) {
+						for (auto iter = vec1.begin(); vec1.end() != iter; ++iter) {
+							(*iter) += 1;
+							sums[0] += (*iter);
+						}
+					}
+					auto t2 = std::chrono::high_resolution_clock::now();
+					times[0] = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+				}
+				{
+					auto t1 = std::chrono::high_resolution_clock::now();
+					for (int i = 0; i < number_of_passes; i += 1) {
+						for (auto iter = vec1.gen_begin(); vec1.gen_end() != iter; ++iter) {
+							(*iter) -= 1;
+							sums[1] += (*iter);
+						}
+					}
+					auto t2 = std::chrono::high_resolution_clock::now();
+					times[1] = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+				}
+				std::cout << "mse::mstd::vector traversal - iterator: " << times[0] << " seconds, gen_iterator: " << times[1] << " seconds.";
+				assert(sums[0] - sums[1] == (long long int)(number_of_elements * number_of_passes));
+				std::cout << std::endl;
+			}
+#endif // !MSE_MSTDVECTOR_DISABLED
+			{
+				/* Loading a (lookup table) file by reading it into a vector vs. mapping it. */
+#ifndef NDEBUG
+				static const size_t number_of_elements = 100000;
+#else // !NDEBUG
+				static const size_t number_of_elements = 10000000;
+#endif // !NDEBUG
+				const char* filename = "msetl_example_mapped_benchmark.bin";
+				{
+					std::vector<int> vec1(number_of_elements, 1);
+					std::ofstream ofs(filename, std::ios::binary);
+					ofs.write(reinterpret_cast<const char*>(vec1.data()), std::streamsize(vec1.size() * sizeof(int)));
+				}
+				double times[2];
+				{
+					auto t1 = std::chrono::high_resolution_clock::now();
+					mse::msevector<int> msevec1(number_of_elements);
+					FILE* file_ptr = fopen(filename, "rb");
+					auto num_read = fread(msevec1.data(), sizeof(int), number_of_elements, file_ptr);
+					fclose(file_ptr);
+					auto value = msevec1[number_of_elements / 2];
+					auto t2 = std::chrono::high_resolution_clock::now();
+					times[0] = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+					assert((number_of_elements == num_read) && (1 == value));
+				}
+				{
+					auto t1 = std::chrono::high_resolution_clock::now();
+					mse::TMappedArray<int> mapped_array1(filename);
+					auto value = mapped_array1[number_of_elements / 2];
+					auto t2 = std::chrono::high_resolution_clock::now();
+					times[1] = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+					assert(1 == value);
+				}
+				std::remove(filename);
+				std::cout << "loading a file and accessing an element - fread() into mse::msevector: " << times[0] << " seconds, mse::TMappedArray: " << times[1] << " seconds.";
+				std::cout << std::endl;
+			}
+			{
+				/* Saving and loading a "snapshot" one (checked) element at a time vs. with mse::serial. */
+#ifndef NDEBUG
+				static const size_t number_of_elements = 100000;
+#else // !NDEBUG
+				static const size_t number_of_elements = 10000000;
+#endif // !NDEBUG
+				mse::msevector<double> msevec1(number_of_elements, 1.5);
+				double times[2];
+				{
+					FILE* file_ptr = std::tmpfile();
+					auto t1 = std::chrono::high_resolution_clock::now();
+					const size_t size1 = msevec1.size();
+					fwrite(&size1, sizeof(size1), 1, file_ptr);
+					for (size_t i = 0; i < size1; i += 1) {
+						const double value = msevec1.at(i);
+						fwrite(&value, sizeof(value), 1, file_ptr);
+					}
+					fflush(file_ptr);
+					std::rewind(file_ptr);
+					size_t size2 = 0;
+					auto num_read = fread(&size2, sizeof(size2), 1, file_ptr);
+					mse::msevector<double> msevec2;
+					for (size_t i = 0; i < size2; i += 1) {
+						double value = 0;
+						num_read += fread(&value, sizeof(value), 1, file_ptr);
+						msevec2.push_back(value);
+					}
+					auto t2 = std::chrono::high_resolution_clock::now();
+					times[0] = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+					std::fclose(file_ptr);
+					assert((number_of_elements + 1 == num_read) && (msevec1 == msevec2));
+				}
+				{
+					FILE* file_ptr = std::tmpfile();
+					auto t1 = std::chrono::high_resolution_clock::now();
+					{
+						mse::serial::CFdWriter writer1(fileno(file_ptr));
+						mse::serial::serialize(writer1, msevec1);
+						writer1.flush();
+					}
+					std::rewind(file_ptr);
+					mse::msevector<double> msevec2;
+					{
+						mse::serial::CFdReader reader1(fileno(file_ptr));
+						mse::serial::deserialize(reader1, msevec2);
+					}
+					auto t2 = std::chrono::high_resolution_clock::now();
+					times[1] = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+					std::fclose(file_ptr);
+					assert(msevec1 == msevec2);
+				}
+				std::cout << "saving and loading a vector - element by element: " << times[0] << " seconds, mse::serial: " << times[1] << " seconds.";
+				std::cout << std::endl;
+			}
 		}
 	}
 
@@ -1822,6 +2389,509 @@ int main(int argc, char* argv[])
 			auto readlock_ptr2 = access_requester.try_readlock_ptr_for(std::chrono::seconds(10));
 			auto writelock_ptr3 = access_requester.try_writelock_ptr_until(std::chrono::steady_clock::now() + std::chrono::seconds(10));
 		}
+		{
+			/* async_writelock_ptr() and async_readlock_ptr() request a lock without blocking the calling thread. Here we
+			use a simple "event loop" (a queue of tasks drained by this thread) as the executor. */
+			auto task_queue_shptr = std::make_shared<std::list<std::function<void()>>>();
+			auto executor = [task_queue_shptr](std::function<void()> task) { task_queue_shptr->push_back(std::move(task)); };
+
+			auto access_requester = mse::make_asyncsharedreadwrite<std::string>("some text");
+
+			/* Another thread will hold a write lock until we tell it to release it. */
+			std::promise<void> lock_obtained_promise;
+			std::promise<void> release_lock_promise;
+			auto lock_holder_future = std::async(std::launch::async, [access_requester](std::promise<void>* lock_obtained_promise_ptr, std::shared_future<void> release_lock_future) mutable {
+				auto writelock_ptr1 = access_requester.writelock_ptr();
+				lock_obtained_promise_ptr->set_value();
+				release_lock_future.wait();
+			}, std::addressof(lock_obtained_promise), release_lock_promise.get_future().share());
+			lock_obtained_promise.get_future().wait();
+
+			auto size_future = access_requester.async_writelock_ptr(executor, [](mse::TAsyncSharedReadWritePointer<std::string> writelock_ptr) {
+				(*writelock_ptr) += " and some more text";
+				return (*writelock_ptr).size();
+			});
+			/* The lock is held by the other thread, so running the queued task(s) won't complete the request. Rather, the
+			request will be re-queued when the lock is released. */
+			while (!(task_queue_shptr->empty())) {
+				auto task = std::move(task_queue_shptr->front());
+				task_queue_shptr->pop_front();
+				task();
+			}
+			assert(std::future_status::ready != size_future.wait_for(std::chrono::seconds(0)));
+
+			release_lock_promise.set_value();
+			lock_holder_future.get();
+			while (!(task_queue_shptr->empty())) {
+				auto task = std::move(task_queue_shptr->front());
+				task_queue_shptr->pop_front();
+				task();
+			}
+			auto new_size = size_future.get();
+			assert(std::string("some text and some more text").size() == new_size);
+		}
+		{
+			/* When MSE_ASYNCSHARED_LOCK_STATS_ENABLED is defined, lock acquisition counts, wait and hold times, etc. are
+			recorded for each shared object type, or for individually named shared objects. */
+			auto access_requester = mse::make_asyncsharedreadwrite<std::string>("some text");
+			access_requester.set_lock_stats_name("example string");
+			{
+				auto writelock_ptr1 = access_requester.writelock_ptr();
+				auto writelock_ptr2 = access_requester.writelock_ptr(); // recursive acquisitions aren't counted
+			}
+			{
+				auto readlock_ptr1 = access_requester.readlock_ptr();
+			}
+#ifdef MSE_ASYNCSHARED_LOCK_STATS_ENABLED
+			for (const auto& item : mse::asyncshared_lock_stats_registry::global().snapshot()) {
+				if ("example string" == item.first) {
+					/* TAsyncSharedReadWriteAccessRequester's readlock_ptr()s hold exclusive locks, so they count as writes. */
+					assert(2 == item.second.write_acquisition_count);
+				}
+			}
+			std::cout << mse::asyncshared_lock_stats_registry::global().to_text();
+			std::string json_str = mse::asyncshared_lock_stats_registry::global().to_json();
+#endif // MSE_ASYNCSHARED_LOCK_STATS_ENABLED
+		}
+		{
+			/* mse::lock_all() obtains write locks on multiple shared objects without risk of deadlock, regardless of the
+			order in which the objects are specified. */
+			class CAccount {
+			public:
+				CAccount(int balance) : m_balance(balance) {}
+				int m_balance = 0;
+			};
+			auto account1_access_requester = mse::make_asyncsharedreadwrite<CAccount>(1000);
+			auto account2_access_requester = mse::make_asyncsharedreadwrite<CAccount>(1000);
+
+			auto transfer = [](mse::TAsyncSharedReadWriteAccessRequester<CAccount> from_access_requester
+				, mse::TAsyncSharedReadWriteAccessRequester<CAccount> to_access_requester, int amount, size_t number_of_transfers) {
+				for (size_t i = 0; i < number_of_transfers; i += 1) {
+					auto writelock_ptrs = mse::lock_all(from_access_requester, to_access_requester);
+					std::get<0>(writelock_ptrs)->m_balance -= amount;
+					std::get<1>(writelock_ptrs)->m_balance += amount;
+				}
+			};
+			/* These two threads lock the same two accounts in opposite orders. */
+			auto future1 = std::async(std::launch::async, transfer, account1_access_requester, account2_access_requester, 3, 1000);
+			auto future2 = std::async(std::launch::async, transfer, account2_access_requester, account1_access_requester, 5, 1000);
+			future1.get();
+			future2.get();
+
+			auto readlock_ptrs = mse::readlock_all(account1_access_requester, account2_access_requester);
+			assert(2000 == std::get<0>(readlock_ptrs)->m_balance + std::get<1>(readlock_ptrs)->m_balance);
+			assert(1000 + 2 * 1000 == std::get<0>(readlock_ptrs)->m_balance);
+		}
+		{
+			/* The shared object and its reference counts are obtained in a single (cache line aligned) allocation. The
+			allocate_asyncshared...() functions (and the access requesters' allocate() static member functions) allow you
+			to specify the allocator to be used. */
+			const auto number_of_allocations_before = H::number_of_allocations_ref();
+			auto access_requester = mse::allocate_asyncsharedreadwrite<std::string>(H::CCountingAllocator<char>(), "some text");
+			assert(number_of_allocations_before + 1 == H::number_of_allocations_ref());
+			assert(std::string("some text") == *(access_requester.readlock_ptr()));
+		}
+		{
+			/* mse::TAsyncSharedShardedMap<> partitions its keys among a number of independently locked shards. Its
+			writelock_ptr() and readlock_ptr() member functions take a key and return a (lock holding) pointer to the
+			shard that contains (or would contain) that key. */
+			auto sharded_map = mse::make_asyncsharedshardedmap<int, std::string>(8);
+			{
+				auto shard_ptr = sharded_map.writelock_ptr(5); // while shard_ptr exists it holds a (write) lock on key 5's shard
+				(*shard_ptr)[5] = "five";
+			}
+			assert(1 == sharded_map.readlock_ptr(5)->count(5));
+			assert(1 == sharded_map.size());
+
+			/* Just a simple benchmark that sweeps the number of shards and threads. */
+#ifndef NDEBUG
+			static const size_t number_of_ops_per_thread = 100/*arbitrary*/;
+#else // !NDEBUG
+			static const size_t number_of_ops_per_thread = 100000/*arbitrary*/;
+#endif // !NDEBUG
+			auto sharded_map_benchmark = [](size_t num_shards, size_t num_threads) {
+				auto map = mse::make_asyncsharedshardedmap<int, int>(num_shards);
+				auto t1 = std::chrono::high_resolution_clock::now();
+				std::list<std::future<void>> futures;
+				for (size_t i = 0; i < num_threads; i += 1) {
+					futures.emplace_back(std::async(std::launch::async, [map, i]() mutable {
+						for (size_t j = 0; j < number_of_ops_per_thread; j += 1) {
+							int key = int((i * number_of_ops_per_thread + j) % 1024);
+							auto shard_ptr = map.writelock_ptr(key);
+							(*shard_ptr)[key] += 1;
+						}
+					}));
+				}
+				for (auto it = futures.begin(); futures.end() != it; it++) {
+					(*it).get();
+				}
+				auto t2 = std::chrono::high_resolution_clock::now();
+				auto time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+				return time_span.count();
+			};
+			std::cout << "TAsyncSharedShardedMap throughput (operations per second):";
+			std::cout << std::endl;
+			for (size_t num_shards : { 1, 4, 16 }) {
+				for (size_t num_threads : { 1, 2, 4, 8 }) {
+					auto timespan_in_seconds = sharded_map_benchmark(num_shards, num_threads);
+					std::cout << "shards: " << num_shards << ", threads: " << num_threads << ", ops/sec: "
+						<< double(num_threads * number_of_ops_per_thread) / timespan_in_seconds;
+					std::cout << std::endl;
+				}
+			}
+			std::cout << std::endl;
+		}
+		{
+			/* apply_async() posts an update to be applied to the shared object by whichever thread holds (or next obtains)
+			the lock, rather than waiting for the lock. */
+			class CCounters {
+			public:
+				size_t m_count = 0;
+				size_t m_total = 0;
+			};
+			auto access_requester = mse::make_asyncsharedreadwrite<CCounters>();
+			access_requester.apply_async([](CCounters& counters) { counters.m_count += 1; counters.m_total += 5; });
+			assert(1 == access_requester.readlock_ptr()->m_count);
+
+			/* A simple benchmark comparing apply_async() with obtaining a write lock for each update. */
+#ifndef NDEBUG
+			static const size_t number_of_ops_per_thread = 100/*arbitrary*/;
+#else // !NDEBUG
+			static const size_t number_of_ops_per_thread = 100000/*arbitrary*/;
+#endif // !NDEBUG
+			auto counter_benchmark = [](size_t num_threads, bool use_apply_async) {
+				auto counters_access_requester = mse::make_asyncsharedreadwrite<CCounters>();
+				auto t1 = std::chrono::high_resolution_clock::now();
+				std::list<std::future<void>> futures;
+				for (size_t i = 0; i < num_threads; i += 1) {
+					futures.emplace_back(std::async(std::launch::async, [counters_access_requester, use_apply_async]() mutable {
+						for (size_t j = 0; j < number_of_ops_per_thread; j += 1) {
+							if (use_apply_async) {
+								counters_access_requester.apply_async([j](CCounters& counters) { counters.m_count += 1; counters.m_total += j; });
+							}
+							else {
+								auto writelock_ptr = counters_access_requester.writelock_ptr();
+								writelock_ptr->m_count += 1;
+								writelock_ptr->m_total += j;
+							}
+						}
+					}));
+				}
+				for (auto it = futures.begin(); futures.end() != it; it++) {
+					(*it).get();
+				}
+				auto t2 = std::chrono::high_resolution_clock::now();
+				/* All posted updates have been applied by the time the updating threads are done. */
+				assert(num_threads * number_of_ops_per_thread == counters_access_requester.readlock_ptr()->m_count);
+				auto time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+				return time_span.count();
+			};
+			std::cout << "apply_async() vs. writelock_ptr() (updates per second):";
+			std::cout << std::endl;
+			for (size_t num_threads : { 1, 2, 4, 8 }) {
+				auto apply_async_timespan_in_seconds = counter_benchmark(num_threads, true);
+				auto writelock_ptr_timespan_in_seconds = counter_benchmark(num_threads, false);
+				std::cout << "threads: " << num_threads << ", apply_async(): " << double(num_threads * number_of_ops_per_thread) / apply_async_timespan_in_seconds
+					<< ", writelock_ptr(): " << double(num_threads * number_of_ops_per_thread) / writelock_ptr_timespan_in_seconds;
+				std::cout << std::endl;
+			}
+			std::cout << std::endl;
+		}
+		{
+			/* Passing mse::asyncshared_big_reader_lock_mode as the first argument when creating a shared object opts it
+			into the "big reader" lock mode, in which (non-exclusive) read locks scale with the number of cores, at the
+			expense of write locks. */
+			auto access_requester = mse::make_asyncsharedobjectthatyouaresurehasnounprotectedmutablesreadwrite<A>(mse::asyncshared_big_reader_lock_mode, 7);
+			{
+				auto readlock_ptr1 = access_requester.readlock_ptr();
+				auto readlock_ptr2 = access_requester.readlock_ptr();
+				assert(7 == readlock_ptr1->b);
+			}
+			access_requester.writelock_ptr()->b = 11;
+			assert(11 == access_requester.readlock_ptr()->b);
+
+			/* A simple benchmark comparing read lock throughput with and without the big reader lock mode. */
+#ifndef NDEBUG
+			static const size_t number_of_ops_per_thread = 100/*arbitrary*/;
+#else // !NDEBUG
+			static const size_t number_of_ops_per_thread = 100000/*arbitrary*/;
+#endif // !NDEBUG
+			auto read_benchmark = [](mse::TAsyncSharedObjectThatYouAreSureHasNoUnprotectedMutablesReadOnlyAccessRequester<A> readonly_access_requester, size_t num_threads) {
+				auto t1 = std::chrono::high_resolution_clock::now();
+				std::list<std::future<void>> futures;
+				for (size_t i = 0; i < num_threads; i += 1) {
+					futures.emplace_back(std::async(std::launch::async, [readonly_access_requester]() mutable {
+						int sum = 0;
+						for (size_t j = 0; j < number_of_ops_per_thread; j += 1) {
+							sum += readonly_access_requester.readlock_ptr()->b;
+						}
+					}));
+				}
+				for (auto it = futures.begin(); futures.end() != it; it++) {
+					(*it).get();
+				}
+				auto t2 = std::chrono::high_resolution_clock::now();
+				auto time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+				return time_span.count();
+			};
+			std::cout << "big reader lock mode vs. default (read locks per second):";
+			std::cout << std::endl;
+			for (size_t num_threads : { 1, 2, 4, 8 }) {
+				auto big_reader_timespan_in_seconds = read_benchmark(mse::make_asyncsharedobjectthatyouaresurehasnounprotectedmutablesreadonly<A>(mse::asyncshared_big_reader_lock_mode, 7), num_threads);
+				auto default_timespan_in_seconds = read_benchmark(mse::make_asyncsharedobjectthatyouaresurehasnounprotectedmutablesreadonly<A>(7), num_threads);
+				std::cout << "threads: " << num_threads << ", big reader: " << double(num_threads * number_of_ops_per_thread) / big_reader_timespan_in_seconds
+					<< ", default: " << double(num_threads * number_of_ops_per_thread) / default_timespan_in_seconds;
+				std::cout << std::endl;
+			}
+			std::cout << std::endl;
+		}
+		{
+			/* mse::TAsyncSharedQueue<> is a bounded, lock-free queue for passing elements between threads. */
+			auto queue = mse::make_asyncsharedqueue<std::string>(16);
+			queue.push("some text");
+			bool push_succeeded = queue.try_push("some more text");
+			assert(push_succeeded);
+			auto str1 = queue.pop();
+			auto maybe_str2 = queue.try_pop();
+			assert(maybe_str2 && ("some more text" == *maybe_str2));
+			assert(!(queue.try_pop_for(std::chrono::milliseconds(1))));
+
+			/* A simple benchmark comparing it with an std::deque shared via a TAsyncSharedReadWriteAccessRequester. Each
+			thread repeatedly pushes an element and then pops an element. */
+#ifndef NDEBUG
+			static const size_t number_of_ops_per_thread = 100/*arbitrary*/;
+#else // !NDEBUG
+			static const size_t number_of_ops_per_thread = 100000/*arbitrary*/;
+#endif // !NDEBUG
+			auto time_threads = [](size_t num_threads, std::function<void()> thread_function) {
+				auto t1 = std::chrono::high_resolution_clock::now();
+				std::list<std::future<void>> futures;
+				for (size_t i = 0; i < num_threads; i += 1) {
+					futures.emplace_back(std::async(std::launch::async, thread_function));
+				}
+				for (auto it = futures.begin(); futures.end() != it; it++) {
+					(*it).get();
+				}
+				auto t2 = std::chrono::high_resolution_clock::now();
+				auto time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+				return time_span.count();
+			};
+			std::cout << "TAsyncSharedQueue vs. access requester wrapped std::deque (push/pop pairs per second):";
+			std::cout << std::endl;
+			for (size_t num_threads : { 1, 2, 4, 8, 16, 32 }) {
+				auto queue1 = mse::make_asyncsharedqueue<int>(64);
+				auto queue_timespan_in_seconds = time_threads(num_threads, [queue1]() mutable {
+					for (size_t j = 0; j < number_of_ops_per_thread; j += 1) {
+						queue1.push(int(j));
+						auto value = queue1.pop();
+					}
+				});
+				auto deque_access_requester = mse::make_asyncsharedreadwrite<std::deque<int>>();
+				auto deque_timespan_in_seconds = time_threads(num_threads, [deque_access_requester]() mutable {
+					for (size_t j = 0; j < number_of_ops_per_thread; j += 1) {
+						deque_access_requester.writelock_ptr()->push_back(int(j));
+						while (true) {
+							auto writelock_ptr = deque_access_requester.writelock_ptr();
+							if (!(writelock_ptr->empty())) {
+								auto value = writelock_ptr->front();
+								writelock_ptr->pop_front();
+								break;
+							}
+						}
+					}
+				});
+				std::cout << "threads: " << num_threads << ", TAsyncSharedQueue: " << double(num_threads * number_of_ops_per_thread) / queue_timespan_in_seconds
+					<< ", std::deque: " << double(num_threads * number_of_ops_per_thread) / deque_timespan_in_seconds;
+				std::cout << std::endl;
+			}
+			std::cout << std::endl;
+		}
+		{
+			/* mse::asyncshared_task_scheduler runs tasks on a (work-stealing) thread pool. Tasks are submitted along with a
+			declaration of the shared objects they access. Tasks that would contend for the same shared object are not run
+			at the same time, so they don't end up blocking (pool) threads waiting for locks. */
+			class CAccount {
+			public:
+				CAccount(int balance) : m_balance(balance) {}
+				int m_balance = 0;
+			};
+			auto account1_access_requester = mse::make_asyncsharedreadwrite<CAccount>(1000);
+			auto account2_access_requester = mse::make_asyncsharedreadwrite<CAccount>(1000);
+			auto account3_access_requester = mse::make_asyncsharedreadwrite<CAccount>(1000);
+
+			mse::asyncshared_task_scheduler scheduler;
+			/* This task can run concurrently with the next one, as they don't access any of the same accounts. */
+			auto future1 = scheduler.submit(mse::asyncshared_task_access().writes(account1_access_requester)
+				, [account1_access_requester]() mutable {
+				account1_access_requester.writelock_ptr()->m_balance += 10;
+			});
+			auto future2 = scheduler.submit(mse::asyncshared_task_access().writes(account2_access_requester).writes(account3_access_requester)
+				, [account2_access_requester, account3_access_requester, &scheduler]() mutable {
+				account2_access_requester.writelock_ptr()->m_balance -= 20;
+				account3_access_requester.writelock_ptr()->m_balance += 20;
+				/* Tasks submitted from within a task are queued on the current worker thread's own deque (from which
+				idle worker threads can "steal" them). */
+				scheduler.submit(mse::asyncshared_task_access().reads(account3_access_requester), [account3_access_requester]() mutable {
+					assert(1020 == account3_access_requester.readlock_ptr()->m_balance);
+				});
+			});
+			/* This one won't start until the previous two tasks have finished. */
+			auto future3 = scheduler.submit(mse::asyncshared_task_access().reads(account1_access_requester).reads(account2_access_requester)
+				, [account1_access_requester, account2_access_requester]() mutable {
+				return account1_access_requester.readlock_ptr()->m_balance + account2_access_requester.readlock_ptr()->m_balance;
+			});
+			future1.get();
+			future2.get();
+			assert(1010 + 980 == future3.get());
+			scheduler.wait_until_idle();
+
+			/* A simple benchmark comparing it with (the ad hoc method of) spreading the tasks over std::async() threads that
+			block on writelock_ptr(). Each task updates one of a few shared objects. */
+#ifndef NDEBUG
+			static const size_t number_of_tasks = 100/*arbitrary*/;
+#else // !NDEBUG
+			static const size_t number_of_tasks = 20000/*arbitrary*/;
+#endif // !NDEBUG
+			static const size_t number_of_accounts = 4;
+			std::vector<mse::TAsyncSharedReadWriteAccessRequester<CAccount>> account_access_requesters;
+			for (size_t i = 0; i < number_of_accounts; i += 1) {
+				account_access_requesters.push_back(mse::make_asyncsharedreadwrite<CAccount>(0));
+			}
+			auto task_function = [](mse::TAsyncSharedReadWriteAccessRequester<CAccount> access_requester) {
+				auto writelock_ptr = access_requester.writelock_ptr();
+				for (int j = 0; j < 100; j += 1) {
+					writelock_ptr->m_balance += j;
+				}
+			};
+			std::cout << "asyncshared_task_scheduler vs. std::async() threads (tasks per second):";
+			std::cout << std::endl;
+			for (size_t num_threads : { 1, 2, 4, 8 }) {
+				auto t1 = std::chrono::high_resolution_clock::now();
+				{
+					mse::asyncshared_task_scheduler scheduler2(num_threads);
+					for (size_t i = 0; i < number_of_tasks; i += 1) {
+						const auto& access_requester = account_access_requesters[i % number_of_accounts];
+						scheduler2.submit(mse::asyncshared_task_access().writes(access_requester), [access_requester, &task_function]() {
+							task_function(access_requester);
+						});
+					}
+					scheduler2.wait_until_idle();
+				}
+				auto t2 = std::chrono::high_resolution_clock::now();
+				{
+					std::list<std::future<void>> futures;
+					for (size_t i = 0; i < num_threads; i += 1) {
+						futures.emplace_back(std::async(std::launch::async, [i, num_threads, &account_access_requesters, &task_function]() {
+							for (size_t j = i; j < number_of_tasks; j += num_threads) {
+								task_function(account_access_requesters[j % number_of_accounts]);
+							}
+						}));
+					}
+					for (auto it = futures.begin(); futures.end() != it; it++) {
+						(*it).get();
+					}
+				}
+				auto t3 = std::chrono::high_resolution_clock::now();
+				auto scheduler_time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+				auto async_time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t3 - t2);
+				std::cout << "threads: " << num_threads << ", asyncshared_task_scheduler: " << double(number_of_tasks) / scheduler_time_span.count()
+					<< ", std::async(): " << double(number_of_tasks) / async_time_span.count();
+				std::cout << std::endl;
+			}
+			std::cout << std::endl;
+		}
+		{
+			/* mse::TChannel<> transfers ownership of (move-only) messages between threads. send() only accepts rvalues, so
+			the sender doesn't retain access to the message. */
+			class CMessage {
+			public:
+				CMessage(size_t id) : m_id(id), m_payload(100, 'a') {}
+				size_t m_id = 0;
+				std::string m_payload;
+			};
+			auto message_channel = mse::make_channel<std::unique_ptr<CMessage>>(64);
+			auto command_channel = mse::make_channel<std::string>(4);
+
+			auto producer_future = std::async(std::launch::async, [message_channel, command_channel]() mutable {
+				message_channel.send(std::unique_ptr<CMessage>(new CMessage(0)));
+				/* send_many() and recv_many() transfer whole batches of messages. */
+				std::vector<std::unique_ptr<CMessage>> batch;
+				for (size_t i = 1; i < 10; i += 1) {
+					batch.emplace_back(new CMessage(i));
+				}
+				message_channel.send_many(std::move(batch));
+				message_channel.close();
+				command_channel.send(std::string("stop"));
+				command_channel.close();
+			});
+
+			size_t number_of_messages_received = 0;
+			size_t number_of_commands_received = 0;
+			while (true) {
+				/* select_recv() waits on multiple channels at once. It returns an empty optional once all of them are
+				closed and drained. */
+				auto maybe_index = mse::select_recv(
+					mse::make_channel_recv_case(message_channel, [&number_of_messages_received](std::unique_ptr<CMessage> message_ptr) {
+						number_of_messages_received += 1;
+					}),
+					mse::make_channel_recv_case(command_channel, [&number_of_commands_received](std::string command) {
+						number_of_commands_received += 1;
+					}));
+				if (!maybe_index) {
+					break;
+				}
+			}
+			producer_future.get();
+			assert(10 == number_of_messages_received);
+			assert(1 == number_of_commands_received);
+			assert(!(message_channel.try_recv()));
+
+			/* A simple benchmark comparing it with giving each message its own access requester. */
+#ifndef NDEBUG
+			static const size_t number_of_messages = 100/*arbitrary*/;
+#else // !NDEBUG
+			static const size_t number_of_messages = 200000/*arbitrary*/;
+#endif // !NDEBUG
+			auto t1 = std::chrono::high_resolution_clock::now();
+			{
+				auto channel1 = mse::make_channel<std::unique_ptr<CMessage>>(64);
+				auto future1 = std::async(std::launch::async, [channel1]() mutable {
+					for (size_t i = 0; i < number_of_messages; i += 1) {
+						channel1.send(std::unique_ptr<CMessage>(new CMessage(i)));
+					}
+					channel1.close();
+				});
+				size_t id_sum = 0;
+				while (auto maybe_message_ptr = channel1.recv()) {
+					id_sum += (*maybe_message_ptr)->m_id;
+				}
+				future1.get();
+			}
+			auto t2 = std::chrono::high_resolution_clock::now();
+			{
+				auto queue1 = mse::make_asyncsharedqueue<mse::TAsyncSharedReadWriteAccessRequester<CMessage>>(64);
+				auto future1 = std::async(std::launch::async, [queue1]() mutable {
+					for (size_t i = 0; i < number_of_messages; i += 1) {
+						queue1.push(mse::make_asyncsharedreadwrite<CMessage>(i));
+					}
+				});
+				size_t id_sum = 0;
+				for (size_t i = 0; i < number_of_messages; i += 1) {
+					auto access_requester = queue1.pop();
+					id_sum += access_requester.readlock_ptr()->m_id;
+				}
+				future1.get();
+			}
+			auto t3 = std::chrono::high_resolution_clock::now();
+			auto channel_time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+			auto access_requester_time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t3 - t2);
+			std::cout << "TChannel vs. per message access requester (messages per second):";
+			std::cout << std::endl;
+			std::cout << "TChannel: " << double(number_of_messages) / channel_time_span.count()
+				<< ", access requester: " << double(number_of_messages) / access_requester_time_span.count();
+			std::cout << std::endl;
+			std::cout << std::endl;
+		}
 		{
 			/* For simple "read-only" scenarios where you need, or want, the shared object to be managed by std::shared_ptrs,
 			TStdSharedImmutableFixedPointer is a "safety enhanced" wrapper for std::shared_ptr. And again, beware of
@@ -1838,6 +2908,101 @@ int main(int argc, char* argv[])
 				int res2 = (*it).get();
 			}
 		}
+		{
+			/* TStdSharedImmutableSnapshotPublisher holds the current version of an immutable object, to which new
+			versions can be published at any time (by any thread). */
+			auto settings_publisher = mse::make_stdsharedimmutablesnapshotpublisher<std::string>("initial settings");
+			auto settings_snapshot1 = settings_publisher.snapshot();
+
+			std::list<std::future<size_t>> futures;
+			for (size_t i = 0; i < 3; i += 1) {
+				futures.emplace_back(std::async(std::launch::async, [settings_publisher]() {
+					size_t total_length = 0;
+					for (size_t j = 0; j < 1000; j += 1) {
+						/* Each snapshot remains valid (and unchanged) regardless of subsequently published versions. */
+						auto settings_snapshot = settings_publisher.snapshot();
+						total_length += settings_snapshot->size();
+					}
+					return total_length;
+				}));
+			}
+			settings_publisher.emplace_and_publish("updated settings");
+			settings_publisher.publish(mse::make_stdsharedimmutable<std::string>("updated settings 2"));
+			for (auto it = futures.begin(); futures.end() != it; it++) {
+				auto total_length = (*it).get();
+			}
+			assert(std::string("initial settings") == *settings_snapshot1);
+			assert(std::string("updated settings 2") == *(settings_publisher.snapshot()));
+			assert(3 == settings_publisher.version());
+		}
+	}
+
+	{
+		/*********************/
+		/*   mse::parallel   */
+		/*********************/
+
+		/* The algorithms in the mse::parallel namespace split a container into disjoint sections, check the bounds of
+		each section (just once) against the container, and process the sections concurrently on a thread pool. */
+
+		std::cout << "mse::parallel test output:";
+		std::cout << std::endl;
+
+#ifndef NDEBUG
+		static const size_t number_of_elements = 10000/*arbitrary*/;
+#else // !NDEBUG
+		static const size_t number_of_elements = 4000000/*arbitrary*/;
+#endif // !NDEBUG
+		{
+			mse::mstd::vector<int> vec1(number_of_elements);
+			for (size_t i = 0; i < vec1.size(); i += 1) {
+				vec1[i] = int((i * 7919) % 1000);
+			}
+
+			mse::parallel::for_each(vec1, [](int& element_ref) { element_ref -= 500; });
+
+			mse::msevector<long long int> msevec1(vec1.size());
+			mse::parallel::transform(vec1, msevec1, [](const int& element_cref) { return 2 * (long long int)(element_cref); });
+
+			auto sum1 = mse::parallel::reduce(msevec1, (long long int)(0));
+			assert(std::accumulate(msevec1.cbegin(), msevec1.cend(), (long long int)(0)) == sum1);
+
+			mse::parallel::inclusive_scan(msevec1, msevec1);
+			assert(sum1 == msevec1.back());
+
+			mse::parallel::sort(vec1, [](const int& a, const int& b) { return a > b; });
+			assert(std::is_sorted(vec1.cbegin(), vec1.cend(), [](const int& a, const int& b) { return a > b; }));
+
+			mse::mstd::array<int, 5> array1 = { 3, 1, 4, 1, 5 };
+			mse::parallel::sort(array1);
+			assert(1 == array1[0]);
+
+			try {
+				/* A destination that's too small is detected before any elements are processed. */
+				mse::mstd::vector<int> vec2(3);
+				mse::parallel::transform(vec1, vec2, [](const int& element_cref) { return element_cref; });
+			}
+			catch (...) {
+				std::cerr << "expected exception" << std::endl;
+			}
+		}
+		{
+			/* A simple benchmark of mse::parallel::transform() with thread pools of various sizes. */
+			auto vec1 = mse::mstd::vector<double>(number_of_elements, 1.5);
+			auto vec2 = mse::mstd::vector<double>(number_of_elements);
+			std::cout << "mse::parallel::transform() (elements per second):";
+			std::cout << std::endl;
+			for (size_t num_threads : { 1, 2, 4, 8 }) {
+				mse::parallel::thread_pool pool(num_threads);
+				auto t1 = std::chrono::high_resolution_clock::now();
+				mse::parallel::transform(pool, vec1, vec2, [](const double& x) { return std::sqrt(x) * x + 1.0; });
+				auto t2 = std::chrono::high_resolution_clock::now();
+				auto time_span = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+				std::cout << "threads: " << num_threads << ", elements/sec: " << double(number_of_elements) / time_span.count();
+				std::cout << std::endl;
+			}
+			std::cout << std::endl;
+		}
 	}
 
 	return 0;